@@ -0,0 +1,361 @@
+#include "CompactMesh.hpp"
+#include "Half.hpp"
+#include "CostCounter.hpp"
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cfloat>
+
+// The negative barycentric weights of a hit just outside a face must sum to more than minus this.
+// It is half of Triangle's tolerance on the sum of the unsigned weights, which counts them twice
+static const float FACE_PADDING = 0.5e-3f;
+
+// Spreads the ten low bits of a value out to every third bit, for 3D Morton codes
+static uint32_t spreadBits3(uint32_t v){
+	v &= 0x3ff;
+	v = ( v | (v << 16) ) & 0x030000ff;
+	v = ( v | (v << 8) ) & 0x0300f00f;
+	v = ( v | (v << 4) ) & 0x030c30c3;
+	v = ( v | (v << 2) ) & 0x09249249;
+	return v;
+}
+
+CompactMesh::CompactMesh(const std::vector<Triangle*>& triangles)
+	: Object( triangles[0]->getMaterial(), triangles[0]->getTexture() ) {
+		
+	normalsProvided = triangles[0]->getNormalsProvided();
+	const bool textured = ( texture != 0 );
+	
+	// Bounds of the whole mesh
+	Vec3f meshMin( FLT_MAX, FLT_MAX, FLT_MAX );
+	Vec3f meshMax( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+	for(int f = 0; f < triangles.size(); f++){
+		for(int k = 0; k < 3; k++){
+			Vec3f p = triangles[f]->getVert(k)->getPos();
+			meshMin = Vec3f( std::min(meshMin.x,p.x), std::min(meshMin.y,p.y), std::min(meshMin.z,p.z) );
+			meshMax = Vec3f( std::max(meshMax.x,p.x), std::max(meshMax.y,p.y), std::max(meshMax.z,p.z) );
+		}
+	}
+	Vec3f meshExtent = meshMax - meshMin;
+	selfEpsilon = 1.e-4f * Vec3f::norm( meshExtent );
+	
+	// Faces are sorted along a Morton curve through their centroids, so that consecutive
+	// faces, and so the faces of each cluster, are close together
+	std::vector< std::pair<uint32_t,int> > keys;
+	for(int f = 0; f < triangles.size(); f++){
+		Vec3f centroid = ( triangles[f]->getVert(0)->getPos() + triangles[f]->getVert(1)->getPos() + triangles[f]->getVert(2)->getPos() ) / 3.f;
+		Vec3f cell = centroid - meshMin;
+		uint32_t x = meshExtent.x > 0.f ? uint32_t( 1023.f * cell.x / meshExtent.x ) : 0;
+		uint32_t y = meshExtent.y > 0.f ? uint32_t( 1023.f * cell.y / meshExtent.y ) : 0;
+		uint32_t z = meshExtent.z > 0.f ? uint32_t( 1023.f * cell.z / meshExtent.z ) : 0;
+		keys.push_back( std::make_pair( spreadBits3(x) | (spreadBits3(y) << 1) | (spreadBits3(z) << 2), f ) );
+	}
+	std::sort( keys.begin(), keys.end() );
+	
+	const int numClusters = ( triangles.size() + CLUSTER_SIZE - 1 ) / CLUSTER_SIZE;
+	
+	// The quantization step is the same for every cluster, and fine enough that the largest
+	// cluster fits in 16 bits. Vertices then lie on one lattice across the whole mesh
+	Vec3f maxClusterExtent( 0.f, 0.f, 0.f );
+	for(int c = 0; c < numClusters; c++){
+		Vec3f boxMin( FLT_MAX, FLT_MAX, FLT_MAX );
+		Vec3f boxMax( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+		for(int f = c*CLUSTER_SIZE; f < std::min( (c+1)*CLUSTER_SIZE, int(triangles.size()) ); f++){
+			for(int k = 0; k < 3; k++){
+				Vec3f p = triangles[ keys[f].second ]->getVert(k)->getPos();
+				boxMin = Vec3f( std::min(boxMin.x,p.x), std::min(boxMin.y,p.y), std::min(boxMin.z,p.z) );
+				boxMax = Vec3f( std::max(boxMax.x,p.x), std::max(boxMax.y,p.y), std::max(boxMax.z,p.z) );
+			}
+		}
+		Vec3f extent = boxMax - boxMin;
+		maxClusterExtent = Vec3f( std::max(maxClusterExtent.x,extent.x), std::max(maxClusterExtent.y,extent.y), std::max(maxClusterExtent.z,extent.z) );
+	}
+	step = Vec3f( maxClusterExtent.x > 0.f ? maxClusterExtent.x / 65534.f : 1.f,
+	              maxClusterExtent.y > 0.f ? maxClusterExtent.y / 65534.f : 1.f,
+	              maxClusterExtent.z > 0.f ? maxClusterExtent.z / 65534.f : 1.f );
+	
+	const float boxPadding = 1.e-5f * Vec3f::norm( meshExtent );
+	
+	std::vector<Vert*> clusterVerts;
+	std::vector<int64_t> lattice;
+	for(int c = 0; c < numClusters; c++){
+		
+		const int firstFace = c*CLUSTER_SIZE;
+		const int lastFace = std::min( (c+1)*CLUSTER_SIZE, int(triangles.size()) );
+		const uint32_t firstVert = positions.size() / 3;
+		
+		// Each cluster has its own copy of the vertices its faces use
+		clusterVerts.clear();
+		for(int f = firstFace; f < lastFace; f++){
+			for(int k = 0; k < 3; k++){
+				Vert* vert = triangles[ keys[f].second ]->getVert(k);
+				int local = std::find( clusterVerts.begin(), clusterVerts.end(), vert ) - clusterVerts.begin();
+				if( local == clusterVerts.size() ){
+					clusterVerts.push_back( vert );
+				}
+				indices.push_back( firstVert + local );
+			}
+		}
+		
+		// Lattice coordinates of the vertices, and the smallest of them along each axis
+		lattice.clear();
+		int64_t base[3] = { INT64_MAX, INT64_MAX, INT64_MAX };
+		for(int v = 0; v < clusterVerts.size(); v++){
+			Vec3f p = clusterVerts[v]->getPos();
+			int64_t g[3] = { std::llround( double(p.x - meshMin.x) / step.x ),
+			                 std::llround( double(p.y - meshMin.y) / step.y ),
+			                 std::llround( double(p.z - meshMin.z) / step.z ) };
+			for(int a = 0; a < 3; a++){
+				lattice.push_back( g[a] );
+				base[a] = std::min( base[a], g[a] );
+			}
+		}
+		
+		Cluster cluster;
+		cluster.origin = Vec3f( float( meshMin.x + double(step.x) * base[0] ),
+		                        float( meshMin.y + double(step.y) * base[1] ),
+		                        float( meshMin.z + double(step.z) * base[2] ) );
+		clusters.push_back( cluster );
+		
+		for(int v = 0; v < clusterVerts.size(); v++){
+			
+			for(int a = 0; a < 3; a++){
+				positions.push_back( uint16_t( std::min( lattice[3*v+a] - base[a], int64_t(65535) ) ) );
+			}
+			
+			if( normalsProvided ){
+				int16_t encoded[2];
+				encodeOctahedral( clusterVerts[v]->getNormal(), encoded );
+				normals.push_back( encoded[0] );
+				normals.push_back( encoded[1] );
+			}
+			
+			if( textured ){
+				Vec2f coords = clusterVerts[v]->getTextureCoords();
+				textureCoords.push_back( Half::fromFloat( coords.x ) );
+				textureCoords.push_back( Half::fromFloat( coords.y ) );
+			}
+			
+		}
+		
+		// The bounding box holds the decoded vertices, padded against rounding in the box test
+		Vec3f boxMin( FLT_MAX, FLT_MAX, FLT_MAX );
+		Vec3f boxMax( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+		for(uint32_t v = firstVert; v < positions.size() / 3; v++){
+			Vec3f p = decodePosition( c, v );
+			boxMin = Vec3f( std::min(boxMin.x,p.x), std::min(boxMin.y,p.y), std::min(boxMin.z,p.z) );
+			boxMax = Vec3f( std::max(boxMax.x,p.x), std::max(boxMax.y,p.y), std::max(boxMax.z,p.z) );
+		}
+		clusters[c].boxMin = boxMin - Vec3f( boxPadding, boxPadding, boxPadding );
+		clusters[c].boxMax = boxMax + Vec3f( boxPadding, boxPadding, boxPadding );
+		
+	}
+	
+}
+
+Vec3f CompactMesh::decodePosition(int c, uint32_t v) const{
+	
+	const Vec3f& origin = clusters[c].origin;
+	return Vec3f( origin.x + step.x * positions[3*v],
+	              origin.y + step.y * positions[3*v+1],
+	              origin.z + step.z * positions[3*v+2] );
+	
+}
+
+bool CompactMesh::hitsCluster(int c, Vec3f origin, Vec3f invDir, float tmin, float tmax) const{
+	
+	const Cluster& cluster = clusters[c];
+	
+	float tx0 = ( cluster.boxMin.x - origin.x ) * invDir.x;
+	float tx1 = ( cluster.boxMax.x - origin.x ) * invDir.x;
+	float ty0 = ( cluster.boxMin.y - origin.y ) * invDir.y;
+	float ty1 = ( cluster.boxMax.y - origin.y ) * invDir.y;
+	float tz0 = ( cluster.boxMin.z - origin.z ) * invDir.z;
+	float tz1 = ( cluster.boxMax.z - origin.z ) * invDir.z;
+	
+	float tNear = std::max( tmin, std::max( std::min(tx0,tx1), std::max( std::min(ty0,ty1), std::min(tz0,tz1) ) ) );
+	float tFar = std::min( tmax, std::min( std::max(tx0,tx1), std::min( std::max(ty0,ty1), std::max(tz0,tz1) ) ) );
+	
+	return tNear <= tFar;
+	
+}
+
+int CompactMesh::findNearestFace(Ray& ray, float tmin, float tmax, float& t, float& u, float& v) const{
+	
+	Vec3f origin = ray.getOrigin();
+	Vec3f dir = ray.getDir();
+	const Vec3f invDir( 1.f / dir.x, 1.f / dir.y, 1.f / dir.z );
+	
+	int nearest = -1;
+	long facesTested = 0;
+	for(int c = 0; c < clusters.size(); c++){
+		
+		if( !hitsCluster( c, origin, invDir, tmin, tmax ) ){
+			continue;
+		}
+		
+		const int lastFace = std::min( (c+1)*CLUSTER_SIZE, int(indices.size() / 3) );
+		facesTested += lastFace - c*CLUSTER_SIZE;
+		for(int f = c*CLUSTER_SIZE; f < lastFace; f++){
+			
+			// Moller-Trumbore test against the decoded vertices
+			Vec3f p0 = decodePosition( c, indices[3*f] );
+			Vec3f e1 = decodePosition( c, indices[3*f+1] ) - p0;
+			Vec3f e2 = decodePosition( c, indices[3*f+2] ) - p0;
+			
+			Vec3f pvec = Vec3f::cross( dir, e2 );
+			// The determinant is the ray direction dotted with the unnormalized face normal. Nearly
+			// parallel rays are skipped with the same cutoff Triangle uses
+			float det = Vec3f::dot( e1, pvec );
+			if( fabs(det) <= 1.e-3f ){
+				continue;
+			}
+			float invDet = 1.f / det;
+			
+			// Triangle accepts points whose unsigned barycentric weights sum to less than 1 + 1.e-3,
+			// which pads each face by a thin band outside its edges. The same band is accepted here
+			// by bounding the sum of the negative weights
+			Vec3f tvec = origin - p0;
+			float fu = Vec3f::dot( tvec, pvec ) * invDet;
+			if( fu < -FACE_PADDING || fu > 1.f + FACE_PADDING ){
+				continue;
+			}
+			
+			Vec3f qvec = Vec3f::cross( tvec, e1 );
+			float fv = Vec3f::dot( dir, qvec ) * invDet;
+			float outside = std::min( fu, 0.f ) + std::min( fv, 0.f ) + std::min( 1.f - fu - fv, 0.f );
+			if( outside <= -FACE_PADDING ){
+				continue;
+			}
+			
+			float ft = Vec3f::dot( e2, qvec ) * invDet;
+			if( ft > 0.f && ft >= tmin && ft < tmax ){
+				tmax = ft;
+				t = ft;
+				u = fu;
+				v = fv;
+				nearest = f;
+			}
+			
+		}
+	}
+	
+	CostCounter::addSteps( clusters.size() );
+	CostCounter::addTests( facesTested );
+	return nearest;
+	
+}
+
+bool CompactMesh::intersect(Ray& ray, RayPayload& rayPayload){
+	
+	float t = 0.f, u = 0.f, v = 0.f;
+	int f = findNearestFace( ray, 0.f, rayPayload.getDistance(), t, u, v );
+	if( f < 0 ){
+		return false;
+	}
+	
+	// Unsigned weights, as Triangle computes them from areas, for hits in the band outside the face
+	Vec3f baries( fabs( 1.f - u - v ), fabs(u), fabs(v) );
+	rayPayload.setDistance(t);
+	rayPayload.setMaterial(material);
+	rayPayload.setBarycentricCoords(baries);
+	rayPayload.setPrimitive(f);
+	
+	if( texture != 0 && texture != NULL ){
+		
+		rayPayload.setTexture(texture);
+		
+		float tu = 0.f, tv = 0.f;
+		for(int k = 0; k < 3; k++){
+			uint32_t vert = indices[3*f+k];
+			float weight = ( k == 0 ) ? baries.x : ( k == 1 ) ? baries.y : baries.z;
+			tu += weight * Half::toFloat( textureCoords[2*vert] );
+			tv += weight * Half::toFloat( textureCoords[2*vert+1] );
+		}
+		Vec2i texIndices = texture -> getIndices( std::min( std::max(tu,0.f), 1.f ), std::min( std::max(tv,0.f), 1.f ) );
+		rayPayload.setTextureColor( texture -> getPixelColor(texIndices) );
+		
+	} else {
+		rayPayload.setTexture(0);
+	}
+	
+	return true;
+	
+}
+
+bool CompactMesh::intersectInterval(Ray& ray, float tmin, float tmax, float& t){
+	
+	float u = 0.f, v = 0.f;
+	return findNearestFace( ray, std::max( tmin, selfEpsilon ), tmax, t, u, v ) >= 0;
+	
+}
+
+Vec3f CompactMesh::getUnitSurfaceNormal(Vec3f pointOnSurface, const RayPayload& rayPayload){
+	
+	const int f = rayPayload.getPrimitive();
+	const int c = f / CLUSTER_SIZE;
+	
+	if( normalsProvided ){
+		Vec3f baries = rayPayload.getBarycentricCoords();
+		return Vec3f::normalize( baries.x * decodeOctahedral( &normals[ 2*indices[3*f] ] ) +
+		                         baries.y * decodeOctahedral( &normals[ 2*indices[3*f+1] ] ) +
+		                         baries.z * decodeOctahedral( &normals[ 2*indices[3*f+2] ] ) );
+	}
+	
+	Vec3f p0 = decodePosition( c, indices[3*f] );
+	Vec3f p1 = decodePosition( c, indices[3*f+1] );
+	Vec3f p2 = decodePosition( c, indices[3*f+2] );
+	return Vec3f::normalize( Vec3f::cross( p1 - p0, p2 - p0 ) );
+	
+}
+
+bool CompactMesh::canOccludeItself() const{
+	return true;
+}
+
+int CompactMesh::getNumFaces() const{
+	return indices.size() / 3;
+}
+
+long CompactMesh::getMemoryBytes() const{
+	
+	return sizeof(CompactMesh) + clusters.capacity() * sizeof(Cluster) + positions.capacity() * sizeof(uint16_t) +
+	       normals.capacity() * sizeof(int16_t) + textureCoords.capacity() * sizeof(uint16_t) + indices.capacity() * sizeof(uint32_t);
+	
+}
+
+// Projects the vector onto the octahedron |x|+|y|+|z| = 1, and folds the lower half over the upper half //
+void CompactMesh::encodeOctahedral(Vec3f n, int16_t encoded[2]){
+	
+	float sum = fabs(n.x) + fabs(n.y) + fabs(n.z);
+	float x = n.x / sum;
+	float y = n.y / sum;
+	
+	if( n.z < 0.f ){
+		float fx = ( 1.f - fabs(y) ) * ( x >= 0.f ? 1.f : -1.f );
+		float fy = ( 1.f - fabs(x) ) * ( y >= 0.f ? 1.f : -1.f );
+		x = fx;
+		y = fy;
+	}
+	
+	encoded[0] = int16_t( std::round( std::min( std::max(x,-1.f), 1.f ) * 32767.f ) );
+	encoded[1] = int16_t( std::round( std::min( std::max(y,-1.f), 1.f ) * 32767.f ) );
+	
+}
+
+Vec3f CompactMesh::decodeOctahedral(const int16_t encoded[2]){
+	
+	float x = encoded[0] / 32767.f;
+	float y = encoded[1] / 32767.f;
+	float z = 1.f - fabs(x) - fabs(y);
+	
+	if( z < 0.f ){
+		float fx = ( 1.f - fabs(y) ) * ( x >= 0.f ? 1.f : -1.f );
+		float fy = ( 1.f - fabs(x) ) * ( y >= 0.f ? 1.f : -1.f );
+		x = fx;
+		y = fy;
+	}
+	
+	return Vec3f::normalize( Vec3f(x,y,z) );
+	
+}
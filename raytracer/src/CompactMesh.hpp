@@ -0,0 +1,144 @@
+/**
+ * \author George Brown
+ *
+ * \file CompactMesh.hpp
+ * \brief Triangles which share a material and texture may be stored together as one compact
+ *        mesh instead of one object per face. The faces are grouped into small clusters with
+ *        bounding boxes. Vertex positions are quantized to 16 bits relative to their cluster,
+ *        normals are octahedral encoded in 32 bits, texture coordinates are half floats, and
+ *        faces are three 32-bit indices. Everything is decoded on the fly during intersection.
+ */
+
+#ifndef COMPACT_MESH_HPP
+#define COMPACT_MESH_HPP
+
+#include <vector>
+#include <cstdint>
+#include "Object.hpp"
+#include "Triangle.hpp"
+#include "Ray.hpp"
+#include "Texture.hpp"
+
+/*! \class CompactMesh Class which stores many triangles in quantized form and intersects them as one object */
+class CompactMesh : public Object {
+	
+	public:
+		
+		/*! Number of faces in each cluster, except possibly the last */
+		static const int CLUSTER_SIZE = 32;
+		
+		/*! CompactMesh constructor. The triangles are copied, and may be deleted afterwards
+		 * \param triangles The triangles, which must all have the same material, texture, and normals flag */
+		CompactMesh(const std::vector<Triangle*>& triangles);
+		
+		/*! Determines whether a ray intersects the mesh, and records the nearest face which was hit.
+		 * \param ray The ray shot out by the raytracer
+		 * \param rayPayload The associated payload data for the ray
+		 * \return True if the ray intersects the mesh closer than the payload's distance, false otherwise */
+		bool intersect(Ray& ray, RayPayload& rayPayload);
+		
+		/*! Determines whether a ray hits the mesh at a distance t with tmin <= t < tmax. Hits closer
+		 *  than a tiny fraction of the mesh size are ignored as well, so that a ray leaving a face
+		 *  does not hit the face it started on.
+		 * \param ray The ray shot out by the raytracer
+		 * \param tmin The smallest distance along the ray which counts as a hit
+		 * \param tmax Hits at this distance or further away are ignored
+		 * \param t Set to the distance along the ray to the nearest hit
+		 * \return True if the ray hits the mesh within the interval, false otherwise */
+		bool intersectInterval(Ray& ray, float tmin, float tmax, float& t);
+		
+		/*! Determines the unit normal of the face recorded in the payload
+		 * \param pointOnSurface The point on the surface of the mesh
+		 * \param rayPayload Payload of the ray which hit the mesh at that point
+		 * \return Unit surface normal */
+		Vec3f getUnitSurfaceNormal(Vec3f pointOnSurface, const RayPayload& rayPayload);
+		
+		/*! A face may block light reaching another face of the same mesh
+		 * \return True */
+		bool canOccludeItself() const;
+		
+		/*! Gets the number of faces in the mesh
+		 * \return Number of faces */
+		int getNumFaces() const;
+		
+		/*! Gets the memory taken up by the mesh data
+		 * \return Number of bytes */
+		long getMemoryBytes() const;
+		
+		/*! Encodes a unit vector as two 16-bit values with an octahedral mapping
+		 * \param n The unit vector
+		 * \param encoded Set to the two encoded values */
+		static void encodeOctahedral(Vec3f n, int16_t encoded[2]);
+		
+		/*! Decodes a unit vector encoded by encodeOctahedral
+		 * \param encoded The two encoded values
+		 * \return The unit vector */
+		static Vec3f decodeOctahedral(const int16_t encoded[2]);
+		
+	private:
+		
+		/*! \struct Cluster A group of nearby faces, along with their vertices */
+		struct Cluster {
+			
+			/*! Position of the vertex whose quantized coordinates are all zero */
+			Vec3f origin;
+			
+			/*! Bounds of the decoded vertices */
+			Vec3f boxMin;
+			Vec3f boxMax;
+			
+		};
+		
+		/*! Decodes the position of a vertex
+		 * \param c Index of the vertex's cluster
+		 * \param v Index of the vertex
+		 * \return The position */
+		Vec3f decodePosition(int c, uint32_t v) const;
+		
+		/*! Tests a ray against a cluster's bounding box
+		 * \param c Index of the cluster
+		 * \param origin Origin of the ray
+		 * \param invDir Reciprocal of each component of the ray direction
+		 * \param tmin Start of the interval along the ray
+		 * \param tmax End of the interval along the ray
+		 * \return True if the ray passes through the box within the interval */
+		bool hitsCluster(int c, Vec3f origin, Vec3f invDir, float tmin, float tmax) const;
+		
+		/*! Finds the nearest face which a ray hits at a distance t with tmin <= t < tmax
+		 * \param ray The ray
+		 * \param tmin The smallest distance along the ray which counts as a hit
+		 * \param tmax Hits at this distance or further away are ignored
+		 * \param t Set to the distance along the ray to the hit
+		 * \param u Set to the barycentric weight of the face's second vertex
+		 * \param v Set to the barycentric weight of the face's third vertex
+		 * \return Index of the face which was hit, or -1 if there was no hit */
+		int findNearestFace(Ray& ray, float tmin, float tmax, float& t, float& u, float& v) const;
+		
+		/*! The clusters, each holding CLUSTER_SIZE consecutive faces */
+		std::vector<Cluster> clusters;
+		
+		/*! Size of one step of the quantized positions along each axis, shared by every cluster
+		 *  so that a vertex shared by two clusters decodes to the same point in both */
+		Vec3f step;
+		
+		/*! Quantized vertex positions, three per vertex */
+		std::vector<uint16_t> positions;
+		
+		/*! Octahedral encoded vertex normals, two per vertex, if the faces have vertex normals */
+		std::vector<int16_t> normals;
+		
+		/*! Half float texture coordinates, two per vertex, if the faces are textured */
+		std::vector<uint16_t> textureCoords;
+		
+		/*! Vertex indices, three per face */
+		std::vector<uint32_t> indices;
+		
+		/*! Hits closer than this are ignored by intersectInterval */
+		float selfEpsilon;
+		
+		/*! True if the faces have vertex normals */
+		bool normalsProvided;
+		
+};
+
+#endif
@@ -0,0 +1,25 @@
+#include "CostCounter.hpp"
+
+thread_local long CostCounter::tests = 0;
+thread_local long CostCounter::steps = 0;
+
+void CostCounter::addTests(long n){
+	tests += n;
+}
+
+void CostCounter::addSteps(long n){
+	steps += n;
+}
+
+void CostCounter::reset(){
+	tests = 0;
+	steps = 0;
+}
+
+long CostCounter::getTests(){
+	return tests;
+}
+
+long CostCounter::getSteps(){
+	return steps;
+}
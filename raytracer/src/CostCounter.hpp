@@ -0,0 +1,44 @@
+/**
+ * \author George Brown
+ *
+ * \file CostCounter.hpp
+ * \brief Counts the work done while tracing a pixel, so that the cost heatmap can show
+ *        where in the image the time goes. Each rendering thread has its own counts.
+ */
+
+#ifndef COST_COUNTER_HPP
+#define COST_COUNTER_HPP
+
+/*! \class CostCounter Class which counts the intersection tests and traversal steps made by the calling thread */
+class CostCounter {
+	
+	public:
+		
+		/*! Adds ray-primitive intersection tests, such as one ray against one sphere or one face
+		 * \param n Number of tests */
+		static void addTests(long n);
+		
+		/*! Adds traversal steps, such as testing a ray against a packet of spheres or a cluster's bounding box
+		 * \param n Number of steps */
+		static void addSteps(long n);
+		
+		/*! Sets the calling thread's counts back to zero */
+		static void reset();
+		
+		/*! Gets the calling thread's intersection tests since the last reset
+		 * \return Number of tests */
+		static long getTests();
+		
+		/*! Gets the calling thread's traversal steps since the last reset
+		 * \return Number of steps */
+		static long getSteps();
+		
+	private:
+		
+		/*! Counts of the calling thread */
+		static thread_local long tests;
+		static thread_local long steps;
+		
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "CostHeatmap.hpp"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+
+CostHeatmap::CostHeatmap(int width_, int height_, const std::string& metric_){
+	
+	width = width_;
+	height = height_;
+	metric = metric_;
+	costs.assign( width*height, 0.0 );
+	
+}
+
+bool CostHeatmap::isValidMetric(const std::string& metric_){
+	return metric_ == "tests" || metric_ == "steps" || metric_ == "time";
+}
+
+const std::string& CostHeatmap::getMetric() const{
+	return metric;
+}
+
+void CostHeatmap::setCost(Vec2i pixel, double cost){
+	costs[ pixel.y*width + pixel.x ] = cost;
+}
+
+void CostHeatmap::save(const std::string& filename) const{
+	
+	// The scale tops out at a high percentile, so that a handful of extreme pixels do not
+	// leave the rest of the image black
+	std::vector<double> sorted( costs );
+	int top = std::min( int( 0.995 * sorted.size() ), int(sorted.size()) - 1 );
+	std::nth_element( sorted.begin(), sorted.begin() + top, sorted.end() );
+	double scale = sorted[top] > 0.0 ? sorted[top] : 1.0;
+	
+	std::ofstream file( filename.c_str(), std::ios::binary );
+	if( !file.is_open() ){
+		std::cout << "Error: Failed to open an output file with the given filename.\n";
+		exit(0);
+	}
+	
+	file << "P6\n" << width << " " << height << "\n255\n";
+	std::vector<unsigned char> row( 3*width );
+	for(int i = 0; i < height; i++){
+		for(int j = 0; j < width; j++){
+			Vec3f color = falseColor( float( costs[i*width + j] / scale ) );
+			row[3*j] = (unsigned char)( 255.f * color.x + 0.5f );
+			row[3*j+1] = (unsigned char)( 255.f * color.y + 0.5f );
+			row[3*j+2] = (unsigned char)( 255.f * color.z + 0.5f );
+		}
+		file.write( (const char*)&row[0], row.size() );
+	}
+	
+	std::cout << "Heatmap file: " << filename << " (white is " << scale << ( metric == "time" ? " ns" : " " + metric ) << " or more)\n";
+	
+}
+
+void CostHeatmap::printSummary(int numRegions) const{
+	
+	double total = 0.0;
+	int hardest = 0;
+	for(int p = 0; p < costs.size(); p++){
+		total += costs[p];
+		if( costs[p] > costs[hardest] ){
+			hardest = p;
+		}
+	}
+	
+	const std::string unit = ( metric == "time" ) ? " ns" : " " + metric;
+	std::cout << "Heatmap: " << total << unit << " in total, " << total / costs.size() << " per pixel, most expensive pixel "
+	          << costs[hardest] << " at (" << hardest % width << ", " << hardest / width << ")\n";
+	if( total <= 0.0 ){
+		return;
+	}
+	
+	// Summing the costs over square regions and listing the most expensive ones
+	const int cols = ( width + REGION_SIZE - 1 ) / REGION_SIZE;
+	const int rows = ( height + REGION_SIZE - 1 ) / REGION_SIZE;
+	std::vector< std::pair<double,int> > regions( cols*rows );
+	for(int r = 0; r < regions.size(); r++){
+		regions[r] = std::make_pair( 0.0, r );
+	}
+	for(int i = 0; i < height; i++){
+		for(int j = 0; j < width; j++){
+			regions[ (i / REGION_SIZE)*cols + j / REGION_SIZE ].first += costs[i*width + j];
+		}
+	}
+	
+	numRegions = std::min( numRegions, int(regions.size()) );
+	std::partial_sort( regions.begin(), regions.begin() + numRegions, regions.end(), std::greater< std::pair<double,int> >() );
+	
+	std::cout << "Most expensive " << REGION_SIZE << "x" << REGION_SIZE << " regions:\n";
+	for(int r = 0; r < numRegions; r++){
+		int x0 = ( regions[r].second % cols ) * REGION_SIZE;
+		int y0 = ( regions[r].second / cols ) * REGION_SIZE;
+		int x1 = std::min( x0 + REGION_SIZE, width ) - 1;
+		int y1 = std::min( y0 + REGION_SIZE, height ) - 1;
+		std::cout << "  pixels " << x0 << "-" << x1 << " x " << y0 << "-" << y1 << ": "
+		          << 100.0 * regions[r].first / total << "% of the total, "
+		          << regions[r].first / ( (x1-x0+1)*(y1-y0+1) ) << unit << " per pixel\n";
+	}
+	
+}
+
+// Piecewise linear scale through black, blue, cyan, green, yellow, red, and white //
+Vec3f CostHeatmap::falseColor(float t){
+	
+	static const float stops[7][3] = {
+		{0.f,0.f,0.f}, {0.f,0.f,1.f}, {0.f,1.f,1.f}, {0.f,1.f,0.f}, {1.f,1.f,0.f}, {1.f,0.f,0.f}, {1.f,1.f,1.f}
+	};
+	
+	t = std::min( std::max( t, 0.f ), 1.f ) * 6.f;
+	int k = std::min( int(t), 5 );
+	float f = t - k;
+	return Vec3f( stops[k][0] + f * ( stops[k+1][0] - stops[k][0] ),
+	              stops[k][1] + f * ( stops[k+1][1] - stops[k][1] ),
+	              stops[k][2] + f * ( stops[k+1][2] - stops[k][2] ) );
+	
+}
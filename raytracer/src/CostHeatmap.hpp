@@ -0,0 +1,76 @@
+/**
+ * \author George Brown
+ *
+ * \file CostHeatmap.hpp
+ * \brief Records what each pixel cost to render, measured as intersection tests, traversal
+ *        steps, or nanoseconds, and saves it as a false colour image next to the render.
+ *        The most expensive regions of the image are listed, which points at the geometry
+ *        that is worth splitting or simplifying.
+ */
+
+#ifndef COST_HEATMAP_HPP
+#define COST_HEATMAP_HPP
+
+#include <vector>
+#include <string>
+#include "Math.hpp"
+
+/*! \class CostHeatmap Class which stores the cost of every pixel of an image */
+class CostHeatmap {
+	
+	public:
+		
+		/*! Edge length in pixels of the regions listed by printSummary */
+		static const int REGION_SIZE = 32;
+		
+		/*! CostHeatmap constructor
+		 * \param width_ Image width in pixels
+		 * \param height_ Image height in pixels
+		 * \param metric_ "tests", "steps", or "time" */
+		CostHeatmap(int width_, int height_, const std::string& metric_);
+		
+		/*! Checks whether a metric is known
+		 * \param metric_ The name of the metric
+		 * \return True if the metric may be given to the constructor */
+		static bool isValidMetric(const std::string& metric_);
+		
+		/*! Getter for the metric
+		 * \return "tests", "steps", or "time" */
+		const std::string& getMetric() const;
+		
+		/*! Sets the cost of a pixel. Each pixel must be set by one thread only
+		 * \param pixel Coordinates of the pixel
+		 * \param cost The pixel's cost in the heatmap's metric */
+		void setCost(Vec2i pixel, double cost);
+		
+		/*! Saves the costs as a binary PPM in false colour, from black for no cost through blue,
+		 *  green, yellow, and red to white for the 99.5th percentile of the costs and above
+		 * \param filename Path of the PPM file */
+		void save(const std::string& filename) const;
+		
+		/*! Prints the total and largest cost, and the most expensive regions of the image
+		 * \param numRegions Number of regions to list */
+		void printSummary(int numRegions) const;
+		
+		/*! Maps a value to the false colour scale
+		 * \param t The value, from 0 to 1
+		 * \return RGB color with components from 0 to 1 */
+		static Vec3f falseColor(float t);
+		
+	private:
+		
+		/*! Image width */
+		int width;
+		
+		/*! Image height */
+		int height;
+		
+		/*! Name of the metric */
+		std::string metric;
+		
+		/*! Cost of each pixel, row by row */
+		std::vector<double> costs;
+		
+};
+
+#endif
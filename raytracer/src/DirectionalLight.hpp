@@ -28,13 +28,10 @@ class DirectionalLight : public Light {
 		 *  \return The L vector used in Phong illumination */
 		Vec3f computeL(Vec3f intersectPoint_);
 		
-		/*! Determines whether the light is blocked by an object, with respect 
-		 *  to a given position on another object's surface
-		 *  \param objects_ Container of pointers to all the objects in the scene
-		 *  \param thisObj_ Pointer to the object in question
+		/*! Computes the shadow ray which travels from a point on a surface towards the light
 		 *  \param surfacePos_ Position on the surface of the object in question
-		 *  \return Boolean flag which is true if the light is blocked, false otherwise. */
-		bool isBlocked(const std::vector<Object*>& objects_, Object* thisObj_, Vec3f surfacePos_);
+		 *  \return The shadow ray */
+		Ray computeShadowRay(Vec3f surfacePos_);
 		
 		/*! Gets the direction of the directional light
 		 *  \return A unit vector pointing in the direction of the directional light */
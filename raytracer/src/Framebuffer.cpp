@@ -0,0 +1,31 @@
+#include "Framebuffer.hpp"
+#include "MemoryFramebuffer.hpp"
+#include "StreamingFramebuffer.hpp"
+
+Framebuffer::Framebuffer(int width_, int height_)
+	: width(width_), height(height_) {
+}
+
+Framebuffer::~Framebuffer(){
+}
+
+Framebuffer* Framebuffer::create(Vec2i dims, const RenderOptions& options, const std::string& filename){
+	
+	if( options.outOfCore ){
+		return new StreamingFramebuffer( dims.x, dims.y, filename );
+	}
+	
+	MemoryFramebuffer::Format format = MemoryFramebuffer::FLOAT;
+	if( options.pixelFormat == "half" ){
+		format = MemoryFramebuffer::HALF;
+	} else if( options.pixelFormat == "rgb8" ){
+		format = MemoryFramebuffer::RGB8;
+	}
+	
+	return new MemoryFramebuffer( dims.x, dims.y, format, filename );
+	
+}
+
+unsigned char Framebuffer::toByte(float c){
+	return int(255.f*c);
+}
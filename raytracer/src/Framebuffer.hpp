@@ -0,0 +1,63 @@
+/**
+ * \author George Brown
+ *
+ * \file Framebuffer.hpp 
+ * \brief The renderer hands finished rows and tiles of pixels to a framebuffer, which either
+ *        keeps them in memory in a chosen pixel format until the image is saved, or writes
+ *        them straight to the output file so that the whole image is never held in memory.
+ */
+
+#ifndef FRAMEBUFFER_HPP
+#define FRAMEBUFFER_HPP
+
+#include <string>
+#include "Math.hpp"
+#include "RenderOptions.hpp"
+
+/*! \class Framebuffer Base class for the destinations of rendered pixels */
+class Framebuffer {
+	
+	public:
+		
+		/*! Framebuffer constructor
+		 * \param width_ The width of the image in pixels
+		 * \param height_ The height of the image in pixels */
+		Framebuffer(int width_, int height_);
+		
+		/*! Framebuffer destructor */
+		virtual ~Framebuffer();
+		
+		/*! Creates the framebuffer selected by the render options
+		 * \param dims The width and height of the image in pixels
+		 * \param options The render options, which select the pixel format and out of core mode
+		 * \param filename The name of the PPM file the image is saved to
+		 * \return The new framebuffer */
+		static Framebuffer* create(Vec2i dims, const RenderOptions& options, const std::string& filename);
+		
+		/*! Stores a finished rectangle of pixels. A row is a tile with a height of 1.
+		 * \param x0 The column of the tile's upper left pixel
+		 * \param y0 The row of the tile's upper left pixel
+		 * \param w The width of the tile in pixels
+		 * \param h The height of the tile in pixels
+		 * \param colors The tile's colors in scanline order, w*h of them */
+		virtual void writeTile(int x0, int y0, int w, int h, const Vec3f* colors) = 0;
+		
+		/*! Completes the output file once every pixel has been written */
+		virtual void finish() = 0;
+		
+		/*! Converts a color channel to the 0-255 value written to the PPM file
+		 * \param c The color channel, in the range 0-1
+		 * \return The value written to the file */
+		static unsigned char toByte(float c);
+		
+	protected:
+		
+		/*! Image width */
+		int width;
+		
+		/*! Image height */
+		int height;
+		
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "Half.hpp"
+#include <cstring>
+
+// Rounds to the nearest half float, handling the full range, with values too large for a
+// half float becoming infinity.
+uint16_t Half::fromFloat(float f){
+	
+	uint32_t bits;
+	memcpy( &bits, &f, sizeof(bits) );
+	
+	const uint16_t sign = ( bits >> 16 ) & 0x8000;
+	const int exponent = int( ( bits >> 23 ) & 0xff ) - 127 + 15;
+	uint32_t mantissa = bits & 0x7fffff;
+	
+	// NaN and infinity
+	if( ( ( bits >> 23 ) & 0xff ) == 0xff ){
+		return sign | 0x7c00 | ( mantissa ? 0x200 : 0 );
+	}
+	
+	// Too large, so the result is infinity
+	if( exponent >= 31 ){
+		return sign | 0x7c00;
+	}
+	
+	// Too small for a normal half float, so the result is subnormal or zero
+	if( exponent <= 0 ){
+		if( exponent < -10 ){
+			return sign;
+		}
+		mantissa |= 0x800000;
+		const int shift = 14 - exponent;
+		uint32_t half = mantissa >> shift;
+		const uint32_t remainder = mantissa & ( (1u << shift) - 1 );
+		const uint32_t halfway = 1u << (shift - 1);
+		if( remainder > halfway || ( remainder == halfway && ( half & 1 ) ) ){
+			half++;
+		}
+		return sign | half;
+	}
+	
+	// Normal half float, rounding the mantissa to the nearest even value. A carry out of the
+	// mantissa correctly moves the result up to the next exponent
+	uint32_t half = ( uint32_t(exponent) << 10 ) | ( mantissa >> 13 );
+	const uint32_t remainder = mantissa & 0x1fff;
+	if( remainder > 0x1000 || ( remainder == 0x1000 && ( half & 1 ) ) ){
+		half++;
+	}
+	return sign | half;
+	
+}
+
+float Half::toFloat(uint16_t h){
+	
+	const uint32_t sign = uint32_t( h & 0x8000 ) << 16;
+	int exponent = ( h >> 10 ) & 0x1f;
+	uint32_t mantissa = h & 0x3ff;
+	uint32_t bits;
+	
+	if( exponent == 0x1f ){
+		bits = sign | 0x7f800000 | ( mantissa << 13 );
+	} else if( exponent == 0 ){
+		if( mantissa == 0 ){
+			bits = sign;
+		} else {
+			// Subnormal, so the mantissa is normalized
+			exponent = 1;
+			while( ( mantissa & 0x400 ) == 0 ){
+				mantissa <<= 1;
+				exponent--;
+			}
+			mantissa &= 0x3ff;
+			bits = sign | ( uint32_t( exponent + 127 - 15 ) << 23 ) | ( mantissa << 13 );
+		}
+	} else {
+		bits = sign | ( uint32_t( exponent + 127 - 15 ) << 23 ) | ( mantissa << 13 );
+	}
+	
+	float f;
+	memcpy( &f, &bits, sizeof(f) );
+	return f;
+	
+}
@@ -0,0 +1,31 @@
+/**
+ * \author George Brown
+ *
+ * \file Half.hpp
+ * \brief 16-bit half floats keep about three significant digits in half the space of a float,
+ *        which is plenty for colors and texture coordinates.
+ */
+
+#ifndef HALF_HPP
+#define HALF_HPP
+
+#include <cstdint>
+
+/*! \class Half Class with conversions between floats and the bits of 16-bit half floats */
+class Half {
+	
+	public:
+		
+		/*! Converts a float to the nearest 16-bit half float
+		 * \param f The float to convert
+		 * \return The bits of the half float */
+		static uint16_t fromFloat(float f);
+		
+		/*! Converts a 16-bit half float to a float
+		 * \param h The bits of the half float
+		 * \return The float with the same value */
+		static float toFloat(uint16_t h);
+		
+};
+
+#endif
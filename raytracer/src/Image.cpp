@@ -1,84 +1,385 @@
 #include "Image.hpp"
 
-Image::Image(Vec2i dims){
-	const int pixw = dims.x;
-	const int pixh = dims.y;
+Image::Image(Vec2i dims, const RenderOptions& options, const std::string& filename){
 	
-	pixels.resize(pixh);
-	for(int j = 0; j < pixels.size(); j++){
-		pixels[j].resize(pixw);  
+	width = dims.x;
+	height = dims.y;
+	framebuffer = Framebuffer::create( dims, options, filename );
+	heatmap = 0;
+	
+	// scene.ppm gets its heatmap in scene.heat.ppm
+	const std::string suffix = ".ppm";
+	heatmapFilename = filename;
+	if( heatmapFilename.size() >= suffix.size() && heatmapFilename.compare( heatmapFilename.size()-suffix.size(), suffix.size(), suffix ) == 0 ){
+		heatmapFilename.erase( heatmapFilename.size()-suffix.size() );
 	}
+	heatmapFilename += ".heat.ppm";
 	
 }
 
+Image::~Image(){
+	delete framebuffer;
+}
+
 
-void Image::draw(Scene scene, Window window){
+void Image::draw(Scene& scene, Window& window){
 	
-	const int pixw = pixels.size();
-	const int pixh = pixels[0].size();
+	if( scene.getRenderOptions().tileCacheFile != "" ){
+		drawIncremental(scene,window);
+		return;
+	}
 	
-	for(int i = 0; i < pixels.size(); i++){
-		for(int j = 0; j < pixels[i].size(); j++) {
-			
-			Vec3f origin = scene.getEyePos();
-			Vec3f windowCoords = window.pixelToWindow(Vec2i(j,i));
-			Vec3f viewDir = Vec3f::normalize(windowCoords - origin);
+	if( scene.getRenderOptions().wavefront ){
+		drawWavefront(scene,window);
+		return;
+	}
+	
+	const RenderOptions& options = scene.getRenderOptions();
+	PixelTraversal traversal( width, height, options.traversal, options.tileSize );
+	
+	if( options.heatmap != "" ){
+		heatmap = new CostHeatmap( width, height, options.heatmap );
+	}
+	
+	int numThreads = options.threads;
+	if( numThreads == 0 ){
+		numThreads = std::max( 1, int(std::thread::hardware_concurrency()) );
+	}
+	
+	// Threads take blocks in traversal order until none are left
+	std::atomic<int> nextBlock(0);
+	if( numThreads == 1 ){
+		renderBlocks( scene, window, traversal, nextBlock );
+	} else {
+		std::vector<std::thread> workers;
+		for(int t = 0; t < numThreads; t++){
+			workers.push_back( std::thread( &Image::renderBlocks, this, std::ref(scene), std::ref(window), std::cref(traversal), std::ref(nextBlock) ) );
+		}
+		for(int t = 0; t < numThreads; t++){
+			workers[t].join();
+		}
+	}
+	
+	if( heatmap != 0 ){
+		heatmap->save( heatmapFilename );
+		heatmap->printSummary(5);
+		delete heatmap;
+		heatmap = 0;
+	}
+
+}
+
+
+void Image::renderBlocks(Scene& scene, Window& window, const PixelTraversal& traversal, std::atomic<int>& nextBlock){
+	
+	std::vector<Vec2i> pixels;
+	std::vector<Vec3f> colors;
+	
+	for(int b = nextBlock++; b < traversal.getNumBlocks(); b = nextBlock++){
+		
+		const PixelBlock& block = traversal.getBlock(b);
+		traversal.getPixels( b, pixels );
+		colors.resize( block.width * block.height );
+		
+		for(int p = 0; p < pixels.size(); p++){
+			colors[ (pixels[p].y - block.y0)*block.width + pixels[p].x - block.x0 ] = renderMeasuredPixel( scene, window, pixels[p] );
+		}
+		
+		// Each block is handed to the framebuffer as soon as it is finished
+		std::lock_guard<std::mutex> lock(framebufferMutex);
+		framebuffer->writeTile( block.x0, block.y0, block.width, block.height, &colors[0] );
+		
+	}
+	
+}
+
+
+Vec3f Image::renderMeasuredPixel(Scene& scene, Window& window, Vec2i pixel){
+	
+	if( heatmap == 0 ){
+		return renderPixel( scene, window, pixel );
+	}
+	
+	CostCounter::reset();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Vec3f color = renderPixel( scene, window, pixel );
+	double nanoseconds = std::chrono::duration<double,std::nano>( std::chrono::steady_clock::now() - start ).count();
+	
+	const std::string& metric = heatmap->getMetric();
+	if( metric == "time" ){
+		heatmap->setCost( pixel, nanoseconds );
+	} else if( metric == "tests" ){
+		heatmap->setCost( pixel, CostCounter::getTests() );
+	} else {
+		heatmap->setCost( pixel, CostCounter::getSteps() );
+	}
+	return color;
+	
+}
+
+Vec3f Image::renderPixel(Scene& scene, Window& window, Vec2i pixel){
+	
+	Vec3f origin = scene.getEyePos();
+	Vec3f windowCoords = window.pixelToWindow(pixel);
+	Vec3f viewDir = Vec3f::normalize(windowCoords - origin);
+	
+	Ray ray(origin,viewDir);
+	RayPayload rayPayload;
+	Random rng( pixel.y*width + pixel.x );
+	
+	scene.traceRay(ray,rayPayload);
+	
+	if( rayPayload.getMaterial() != 0 && rayPayload.getMaterial() != NULL ){
+		return scene.shadeRay(ray,rayPayload,rng);
+	} else {
+		return scene.getBkgColor();
+	}
+	
+}
+
+
+void Image::drawWavefront(Scene& scene, Window& window){
+	
+	const int batchSize = scene.getRenderOptions().batchSize;
+	
+	WavefrontRenderer renderer(scene,window,width);
+	std::vector<Vec2i> pixelCoords;
+	std::vector<Vec3f> colors;
+	
+	// The image is cut into batches of consecutive pixels in scanline order
+	for(int start = 0; start < width*height; start += batchSize){
+		
+		pixelCoords.clear();
+		for(int p = start; p < std::min(start+batchSize, width*height); p++){
+			pixelCoords.push_back( Vec2i( p % width, p / width ) );
+		}
+		
+		renderer.renderBatch(pixelCoords,colors);
+		
+		// A batch covers the end of one row, whole rows, and the start of another row
+		for(int p = 0; p < pixelCoords.size(); ){
+			int runLength = std::min( width - pixelCoords[p].x, int(pixelCoords.size()) - p );
+			framebuffer->writeTile( pixelCoords[p].x, pixelCoords[p].y, runLength, 1, &colors[p] );
+			p += runLength;
+		}
+		
+	}
+	
+}
+
+void Image::drawIncremental(Scene& scene, Window& window){
+	
+	const RenderOptions& options = scene.getRenderOptions();
+	
+	// Render options which change the image are treated like edits to the view
+	std::stringstream optionString;
+	optionString << options.lightCutoff << " " << options.lightSamples << " " << options.smoothNormals << " " << options.compactMeshes
+	             << " " << options.weldEpsilon << " " << options.maxDepth << " " << options.minContribution
+	             << " " << options.rouletteDepth << " " << options.rayBudget;
+	
+	TileCache cache;
+	cache.viewSignature = TileCache::hashCombine( scene.getViewSignature(), TileCache::hashString( optionString.str() ) );
+	cache.geometrySignature = scene.getGeometrySignature();
+	cache.width = width;
+	cache.height = height;
+	cache.tileSize = 16;
+	
+	std::vector<Object*> objects = scene.getObjects();
+	std::unordered_map<Object*,int> objectIndices;
+	for(int i = 0; i < objects.size(); i++){
+		cache.objectSignatures.push_back( objects[i]->getSignature() );
+		objectIndices[ objects[i] ] = i;
+	}
+	for(int l = 0; l < scene.getNumLights(); l++){
+		cache.lightSignatures.push_back( scene.getLight(l)->getSignature() );
+	}
+	
+	const Vec2i numTiles = cache.getNumTiles();
+	cache.tiles.resize( numTiles.x*numTiles.y );
+	std::vector<char> dirty( cache.tiles.size(), 1 );
+	std::vector<int> lightRemap;
+	
+	// Any change to the view or the geometry may change every tile, so the cached tiles
+	// are only reused when both are unchanged
+	TileCache previous;
+	std::string reason = "";
+	if( !previous.load( options.tileCacheFile ) ){
+		reason = "no previous render was found";
+	} else if( previous.viewSignature != cache.viewSignature || previous.width != width || previous.height != height || previous.tileSize != cache.tileSize ){
+		reason = "the camera, image, or render options changed";
+	} else if( previous.geometrySignature != cache.geometrySignature ){
+		reason = "the geometry changed";
+	} else {
+		findDirtyTiles( scene, previous, cache, dirty, lightRemap );
+	}
+	
+	int numRendered = 0;
+	for(int t = 0; t < cache.tiles.size(); t++){
+		
+		Vec2i tileCoords( t % numTiles.x, t / numTiles.x );
+		if( dirty[t] ){
+			renderTile( scene, window, objectIndices, tileCoords, cache.tileSize, cache.tiles[t] );
+			numRendered++;
+		} else {
+			cache.tiles[t] = previous.tiles[t];
+			for(int i = 0; i < cache.tiles[t].lights.size(); i++){
+				cache.tiles[t].lights[i] = lightRemap[ cache.tiles[t].lights[i] ];
+			}
+		}
+		
+		// Handing the tile to the framebuffer
+		int x0 = tileCoords.x*cache.tileSize;
+		int y0 = tileCoords.y*cache.tileSize;
+		framebuffer->writeTile( x0, y0, std::min( cache.tileSize, width-x0 ), std::min( cache.tileSize, height-y0 ), &cache.tiles[t].colors[0] );
+		
+	}
+	
+	std::cout << "Tile cache: re-rendered " << numRendered << " of " << cache.tiles.size() << " tiles";
+	if( reason != "" ){
+		std::cout << " because " << reason;
+	}
+	std::cout << std::endl;
+	
+	cache.save( options.tileCacheFile );
+	
+}
+
+void Image::renderTile(Scene& scene, Window& window, const std::unordered_map<Object*,int>& objectIndices,
+                       Vec2i tileCoords, int tileSize, TileRecord& record){
+	
+	record.hasHits = false;
+	record.boxMin = Vec3f( FLT_MAX, FLT_MAX, FLT_MAX );
+	record.boxMax = Vec3f( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+	record.objects.clear();
+	record.lights.clear();
+	record.colors.clear();
+	
+	std::vector<int> candidates;
+	std::vector<SurfaceHit> secondaryHits;
+	for(int i = tileCoords.y*tileSize; i < std::min( (tileCoords.y+1)*tileSize, height ); i++){
+		for(int j = tileCoords.x*tileSize; j < std::min( (tileCoords.x+1)*tileSize, width ); j++){
 			
-			Ray ray(origin,viewDir);
+			Ray ray = window.getPrimaryRay( Vec2i(j,i) );
 			RayPayload rayPayload;
+			Random rng( i*width + j );
 			
 			scene.traceRay(ray,rayPayload);
 			
 			Vec3f colors;
 			if( rayPayload.getMaterial() != 0 && rayPayload.getMaterial() != NULL ){
-				colors = scene.shadeRay(ray,rayPayload);
+				
+				secondaryHits.clear();
+				colors = scene.shadeRay(ray,rayPayload,rng,&secondaryHits);
+				
+				// The tile depends on the objects which were hit, including those seen in reflections
+				// and through transparent objects, and on the lights considered at each hit
+				Vec3f point = ray.getOrigin() + rayPayload.getDistance() * ray.getDir();
+				secondaryHits.push_back( SurfaceHit() );
+				secondaryHits.back().point = point;
+				secondaryHits.back().obj = rayPayload.getObject();
+				record.hasHits = true;
+				for(int h = 0; h < secondaryHits.size(); h++){
+					Vec3f p = secondaryHits[h].point;
+					record.boxMin = Vec3f( std::min(record.boxMin.x,p.x), std::min(record.boxMin.y,p.y), std::min(record.boxMin.z,p.z) );
+					record.boxMax = Vec3f( std::max(record.boxMax.x,p.x), std::max(record.boxMax.y,p.y), std::max(record.boxMax.z,p.z) );
+					record.objects.push_back( objectIndices.at( secondaryHits[h].obj ) );
+					scene.getCandidateLights( p, candidates );
+				}
+				
 			} else {
 				colors = scene.getBkgColor();
 			}
 			
-			pixels[i][j].setRgb(colors);
+			record.colors.push_back( colors );
 			
 		}
 	}
-
+	
+	std::sort( record.objects.begin(), record.objects.end() );
+	record.objects.erase( std::unique( record.objects.begin(), record.objects.end() ), record.objects.end() );
+	std::sort( candidates.begin(), candidates.end() );
+	candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+	record.lights = candidates;
+	
 }
 
-
-
-void Image::saveToPpm(const std::string& filename){
+void Image::findDirtyTiles(Scene& scene, const TileCache& previous, const TileCache& current,
+                           std::vector<char>& dirty, std::vector<int>& lightRemap){
+	
+	// Objects are matched by index, which is safe because the geometry is unchanged
+	std::vector<char> objectChanged( current.objectSignatures.size(), 0 );
+	for(int i = 0; i < objectChanged.size(); i++){
+		objectChanged[i] = ( previous.objectSignatures[i] != current.objectSignatures[i] );
+	}
 	
-	std::cout << "Output file: " << filename << std::endl;
+	// Lights are matched by signature, so that adding or removing one light does not disturb the
+	// others. An edited light counts as removing the old light and adding a new one
+	std::unordered_map< uint64_t, std::vector<int> > unmatched;
+	for(int l = current.lightSignatures.size()-1; l >= 0; l--){
+		unmatched[ current.lightSignatures[l] ].push_back(l);
+	}
+	lightRemap.assign( previous.lightSignatures.size(), -1 );
+	std::vector<char> added( current.lightSignatures.size(), 1 );
+	for(int l = 0; l < previous.lightSignatures.size(); l++){
+		std::vector<int>& candidates = unmatched[ previous.lightSignatures[l] ];
+		if( !candidates.empty() ){
+			lightRemap[l] = candidates.back();
+			added[ candidates.back() ] = 0;
+			candidates.pop_back();
+		}
+	}
 	
-	std::ofstream outputfile( filename.c_str() );
+	// An added light may reach points which no light reached before. Its region of influence
+	// is compared against the bounds of each tile's hit points
+	std::vector<Vec3f> centers;
+	std::vector<float> radii;
+	for(int l = 0; l < current.lightSignatures.size(); l++){
+		Vec3f center;
+		float radius = 0.f;
+		if( added[l] ){
+			if( !scene.getLight(l)->getInfluenceSphere( scene.getRenderOptions().lightCutoff, center, radius ) ){
+				radius = FLT_MAX;
+			}
+			centers.push_back(center);
+			radii.push_back(radius);
+		}
+	}
 	
-	if( outputfile.is_open() ){
+	for(int t = 0; t < previous.tiles.size(); t++){
 		
-		int width = pixels[0].size();
-		int height = pixels.size();
+		const TileRecord& tile = previous.tiles[t];
 		
-		// The standard ppm format.
-		std::stringstream ss( std::string("") );
-		ss << "P3\n";
-		ss << "# ppm data for an image with a given width, height, and pixel values from 0-255 \n";
-		ss << width << " " << height << std::endl;
-		ss << 255 << std::endl;
+		// Only the background was visible, and it cannot have changed
+		if( !tile.hasHits ){
+			dirty[t] = 0;
+			continue;
+		}
 		
-		// Looping through the image data and writing the rgb values.  Each pixel gets its own line.
-		for(int i = 0; i < height; i++){
-			for(int j = 0; j < width; j++){
-				Vec3f rgb = pixels[i][j].getRgb();
-					ss << int(255.f*rgb.x) << " "
-					   << int(255.f*rgb.y) << " "
-					   << int(255.f*rgb.z) << std::endl;
+		bool affected = false;
+		for(int i = 0; i < tile.objects.size() && !affected; i++){
+			affected = objectChanged[ tile.objects[i] ];
+		}
+		for(int i = 0; i < tile.lights.size() && !affected; i++){
+			affected = ( lightRemap[ tile.lights[i] ] == -1 );
+		}
+		for(int i = 0; i < centers.size() && !affected; i++){
+			if( radii[i] == FLT_MAX ){
+				affected = true;
+			} else {
+				Vec3f c = centers[i];
+				Vec3f closest( std::min( std::max(c.x,tile.boxMin.x), tile.boxMax.x ),
+				               std::min( std::max(c.y,tile.boxMin.y), tile.boxMax.y ),
+				               std::min( std::max(c.z,tile.boxMin.z), tile.boxMax.z ) );
+				affected = Vec3f::dot( closest - c, closest - c ) <= radii[i]*radii[i];
 			}
 		}
 		
-
-		outputfile << ss.rdbuf();
+		dirty[t] = affected;
 		
-	} else {
-		std::cout << "Error: Failed to open an output file with the given filename.\n";
-		exit(0);
 	}
 	
 }
+
+void Image::saveToPpm(){
+	framebuffer->finish();
+}
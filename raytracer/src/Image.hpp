@@ -4,7 +4,8 @@
  * \file Image.hpp 
  * \brief The final image produced by the raytracer program is an array of pixels.
  *        Functionality is provided for drawing an image of a given scene with viewing
- *        window parameters, and for saving the pixel array to a PPM file.
+ *        window parameters, and for saving the pixel array to a PPM file. The pixels are
+ *        handed to a framebuffer as soon as they are finished.
  */
 
 #ifndef IMAGE_HPP
@@ -15,40 +16,120 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include <cfloat>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
 
 #include "Math.hpp"
-#include "Pixel.hpp"
+#include "Framebuffer.hpp"
 #include "Scene.hpp"
 #include "Window.hpp"
 #include "Ray.hpp"
+#include "WavefrontRenderer.hpp"
+#include "TileCache.hpp"
+#include "PixelTraversal.hpp"
+#include "CostCounter.hpp"
+#include "CostHeatmap.hpp"
 
 /*! \class Image Class which defines an image which is drawn from casting rays through a 3D scene
- The image contains an array of pixels */ 
+ The finished pixels are stored by a framebuffer */ 
 class Image {
 	
 	public:
 	
 		/*! Image constructor.
 		 *  \param dims The dimensions of the image, a 2d vector of ints corresponding to
-		 *         the number of pixels for the width and height of the image */
-		Image(Vec2i dims);
+		 *         the number of pixels for the width and height of the image
+		 *  \param options The render options, which select the framebuffer
+		 *  \param filename The name of the PPM file to save the image to */
+		Image(Vec2i dims, const RenderOptions& options, const std::string& filename);
+		
+		/*! Image destructor */
+		~Image();
 		
 		
 		/*! Draw an image of the current scene with the current window information to yield
-		 *  an array of pixel data
+		 *  an array of pixel data. Pixels are traced in the traversal order and by the number
+		 *  of threads given in the render options. If the options ask for a heatmap, it is
+		 *  saved next to the image and its most expensive regions are printed
+		 *  \param scene The scene which contains all the objects and environment data.
+		 *  \param window The window through which the scene is viewed */
+		void draw(Scene& scene, Window& window);
+		
+		/*! Draws the image in batches with the wavefront pipeline. The result is the same as draw.
+		 *  \param scene The scene which contains all the objects and environment data.
+		 *  \param window The window through which the scene is viewed */
+		void drawWavefront(Scene& scene, Window& window);
+		
+		/*! Draws the image tile by tile, reusing the tiles of the previous render which are not
+		 *  affected by edits to the scene since then. The tiles are read from and saved back to
+		 *  the tile cache file given in the render options. The result is the same as draw.
 		 *  \param scene The scene which contains all the objects and environment data.
 		 *  \param window The window through which the scene is viewed */
-		void draw(Scene scene, Window window);
+		void drawIncremental(Scene& scene, Window& window);
 		
 		
-		/*! Saves the pixel array data to a PPM file to be viewed by an external program
-		 *  \param filename The name of the file to save the data to. */
-		void saveToPpm(const std::string& filename);
+		/*! Saves the image to the PPM file given to the constructor, once it has been drawn */
+		void saveToPpm();
 	
 	private:
 	
-		/*! 2D-array of pixels for the image */
-		std::vector< std::vector<Pixel> > pixels;
+		/*! Traces blocks of pixels, taking the next block in traversal order until none are left.
+		 *  Runs on every rendering thread
+		 *  \param scene The scene which contains all the objects and environment data.
+		 *  \param window The window through which the scene is viewed
+		 *  \param traversal The blocks of the image in traversal order
+		 *  \param nextBlock Position of the next block which no thread has taken yet */
+		void renderBlocks(Scene& scene, Window& window, const PixelTraversal& traversal, std::atomic<int>& nextBlock);
+		
+		/*! Traces a pixel, and records its cost in the heatmap if there is one
+		 *  \param scene The scene which contains all the objects and environment data.
+		 *  \param window The window through which the scene is viewed
+		 *  \param pixel Coordinates of the pixel
+		 *  \return The color of the pixel */
+		Vec3f renderMeasuredPixel(Scene& scene, Window& window, Vec2i pixel);
+		
+		/*! Traces the primary ray through a pixel and shades the hit
+		 *  \param scene The scene which contains all the objects and environment data.
+		 *  \param window The window through which the scene is viewed
+		 *  \param pixel Coordinates of the pixel
+		 *  \return The color of the pixel */
+		Vec3f renderPixel(Scene& scene, Window& window, Vec2i pixel);
+		
+		/*! Traces every pixel of a tile and records what the tile depends on
+		 *  \param scene The scene which contains all the objects and environment data.
+		 *  \param window The window through which the scene is viewed
+		 *  \param objectIndices Index of each object in the scene
+		 *  \param tileCoords Coordinates of the tile, in tiles
+		 *  \param tileSize Edge length of a tile in pixels
+		 *  \param record Set to the tile's colors and dependencies */
+		void renderTile(Scene& scene, Window& window, const std::unordered_map<Object*,int>& objectIndices,
+		                Vec2i tileCoords, int tileSize, TileRecord& record);
+		
+		/*! Determines which tiles of a previous render are affected by edits to the scene
+		 *  \param scene The edited scene
+		 *  \param previous The tiles and signatures of the previous render
+		 *  \param current The signatures of the edited scene
+		 *  \param dirty Set to true for every tile which must be traced again
+		 *  \param lightRemap Set to the current index of each previous light, or -1 if it was removed or edited */
+		void findDirtyTiles(Scene& scene, const TileCache& previous, const TileCache& current,
+		                    std::vector<char>& dirty, std::vector<int>& lightRemap);
+	
+		/*! Destination for the finished pixels */
+		Framebuffer* framebuffer;
+		
+		/*! Cost of each pixel, while drawing with a heatmap */
+		CostHeatmap* heatmap;
+		
+		/*! The PPM file the heatmap is saved to, next to the image */
+		std::string heatmapFilename;
+		
+		/*! Lets one thread at a time hand pixels to the framebuffer */
+		std::mutex framebufferMutex;
 		
 		/*! Image width */
 		int width;
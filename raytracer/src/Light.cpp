@@ -1,6 +1,14 @@
 #include "Light.hpp"
+#include <cfloat>
+#include "CostCounter.hpp"
 
-Light::Light(Vec3f rgb_){
+// The object which last blocked each light on the current thread, indexed by cache slot
+static thread_local std::vector<Object*> lastOccluders;
+
+std::atomic<int> Light::numCacheSlots(0);
+
+Light::Light(Vec3f rgb_)
+	: shadowEpsilon(0.f), signature(0), cacheLookups(0), cacheHits(0) {
 
 	if( rgb_.x < 0.f || rgb_.x > 1.f || rgb_.y < 0.f || rgb_.y > 1.f || rgb_.z < 0.f || rgb_.z > 1.f ){
 		std::cout << "Error: The specified RGB color values for the 'light' are invalid. Each value must\n";
@@ -9,8 +17,92 @@ Light::Light(Vec3f rgb_){
 	}
 
 	rgb = rgb_;
+	cacheSlot = numCacheSlots++;
 }
 
 Vec3f Light::getRGB() const{
 	return rgb;
 }
+
+float Light::computeAttenuation(Vec3f intersectPoint_){
+	return 1.f;
+}
+
+bool Light::getInfluenceSphere(float cutoff, Vec3f& center, float& radius){
+	return false;
+}
+
+float Light::computeShadowDistance(Vec3f surfacePos_){
+	return FLT_MAX;
+}
+
+long Light::getShadowCacheLookups() const{
+	return cacheLookups.load(std::memory_order_relaxed);
+}
+
+long Light::getShadowCacheHits() const{
+	return cacheHits.load(std::memory_order_relaxed);
+}
+
+uint64_t Light::getSignature() const{
+	return signature;
+}
+
+void Light::setSignature(uint64_t signature_){
+	signature = signature_;
+}
+
+// Determines whether the light is blocked by an object, with respect to a given position on another object's surface
+bool Light::isBlocked(const std::vector<Object*>& objects_, Object* thisObj_, Vec3f surfacePos_){
+	
+	static const std::vector<SpherePacket> noSpherePackets;
+	Ray shadowRay = computeShadowRay(surfacePos_);
+	return isBlocked(objects_, noSpherePackets, thisObj_, shadowRay, computeShadowDistance(surfacePos_));
+	
+}
+
+bool Light::isBlocked(const std::vector<Object*>& objects_, const std::vector<SpherePacket>& spherePackets_,
+                      Object* thisObj_, Ray& shadowRay, float shadowDistance){
+	
+	if( lastOccluders.size() <= cacheSlot ){
+		lastOccluders.resize(cacheSlot+1,0);
+	}
+	Object*& cached = lastOccluders[cacheSlot];
+	
+	// The occluder found by the previous query is tested first
+	if( cached != 0 && ( cached != thisObj_ || cached->canOccludeItself() ) ){
+		cacheLookups.fetch_add(1,std::memory_order_relaxed);
+		if( occludes(cached,shadowRay,shadowDistance) ){
+			cacheHits.fetch_add(1,std::memory_order_relaxed);
+			return true;
+		}
+	}
+	
+	// Otherwise every object is tested, stopping at the first one which blocks the light
+	for(int i = 0; i < spherePackets_.size(); i++){
+		CostCounter::addSteps(1);
+		CostCounter::addTests( spherePackets_[i].size() );
+		int lane = spherePackets_[i].occludes( shadowRay, shadowEpsilon, shadowDistance, thisObj_ );
+		if( lane >= 0 ){
+			cached = spherePackets_[i].getSphere(lane);
+			return true;
+		}
+	}
+	for(int i = 0; i < objects_.size(); i++){
+		if( ( objects_[i] != thisObj_ || objects_[i]->canOccludeItself() ) && objects_[i] != cached && occludes(objects_[i],shadowRay,shadowDistance) ){
+			cached = objects_[i];
+			return true;
+		}
+	}
+	
+	return false;
+	
+}
+
+bool Light::occludes(Object* obj, Ray& shadowRay, float shadowDistance){
+	
+	CostCounter::addTests(1);
+	float t = 0.f;
+	return obj->intersectInterval( shadowRay, shadowEpsilon, shadowDistance, t );
+	
+}
@@ -9,13 +9,16 @@
 #define LIGHT_HPP
 
 #include <vector>
+#include <atomic>
+#include <cstdint>
 #include "Math.hpp"
 #include "Object.hpp"
 #include "Ray.hpp"
+#include "SpherePacket.hpp"
 
 /*! \class Light Base class from which all types of lights are derived. Every light has color wavelength data, which is stored in the base class.
  This class also provides a virtual interface, requiring all classes inheriting from it to provide functions for computing L
- and determining whether the light is blocked by an object in the scene */
+ and the shadow ray used to determine whether the light is blocked by an object in the scene */
 class Light {
 	
 	public:
@@ -29,21 +32,101 @@ class Light {
 		 *  \return The L vector used in Phong illumination */
 		virtual Vec3f computeL(Vec3f intersectPoint_) = 0;
 		
+		/*! Computes the factor by which the light's intensity is attenuated on its way to a point.
+		 *  Lights are unattenuated unless a derived class says otherwise.
+		 *  \param intersectPoint_ The point being illuminated
+		 *  \return The attenuation factor */
+		virtual float computeAttenuation(Vec3f intersectPoint_);
+		
+		/*! Determines the sphere outside of which the light contributes less than a cutoff value.
+		 *  \param cutoff The smallest contribution which is considered meaningful
+		 *  \param center Set to the center of the sphere
+		 *  \param radius Set to the radius of the sphere
+		 *  \return True if the light's influence is bounded, false if it reaches every point */
+		virtual bool getInfluenceSphere(float cutoff, Vec3f& center, float& radius);
+		
+		/*! Computes the shadow ray which travels from a point on a surface towards the light
+		 *  \param surfacePos_ The point on the surface of the object
+		 *  \return The shadow ray */
+		virtual Ray computeShadowRay(Vec3f surfacePos_) = 0;
+		
+		/*! Computes how far a shadow ray travels from a point on a surface before reaching the light.
+		 *  Objects further away than this cannot block the light. Lights are infinitely far away
+		 *  unless a derived class says otherwise.
+		 *  \param surfacePos_ The point on the surface of the object
+		 *  \return The distance to the light */
+		virtual float computeShadowDistance(Vec3f surfacePos_);
+		
 		/*! Determines whether the light is blocked by an object, 
-		 *  with respect to a given position on another object's surface
+		 *  with respect to a given position on another object's surface.
+		 *  Neighbouring shading points are usually blocked by the same object, so the
+		 *  object which blocked this light on the previous query from the calling thread
+		 *  is tested first, before falling back to a traversal over all objects.
 		 *  \param objects_ A vector of pointers to all the objects in the scene
 		 *  \param thisObj_ A pointer to the object in question whose surface the ray is at
 		 *  \param surfacePos_ The point on the surface of the object
 		 *  \return Boolean flag which is true if the light is blocked, false otherwise. */
-		virtual bool isBlocked(const std::vector<Object*>& objects_, Object* thisObj_, Vec3f surfacePos_) = 0;
+		bool isBlocked(const std::vector<Object*>& objects_, Object* thisObj_, Vec3f surfacePos_);
+		
+		/*! Determines whether the light is blocked along a shadow ray which was already computed
+		 *  with computeShadowRay and computeShadowDistance.
+		 *  \param objects_ A vector of pointers to the objects in the scene which are not in a sphere packet
+		 *  \param spherePackets_ The spheres in the scene, packed for testing several at once
+		 *  \param thisObj_ A pointer to the object in question whose surface the ray starts at
+		 *  \param shadowRay The ray travelling from the surface towards the light
+		 *  \param shadowDistance The distance along the ray to the light
+		 *  \return Boolean flag which is true if the light is blocked, false otherwise. */
+		bool isBlocked(const std::vector<Object*>& objects_, const std::vector<SpherePacket>& spherePackets_,
+		               Object* thisObj_, Ray& shadowRay, float shadowDistance);
 		
 		/*! Gets the RGB color data
 		 * \return The RGB color data as a 3D float vector */
 		Vec3f getRGB() const;
 		
+		/*! Gets the number of shadow queries which consulted the occluder cache
+		 * \return Number of occluder cache lookups across all threads */
+		long getShadowCacheLookups() const;
+		
+		/*! Gets the number of shadow queries answered by the cached occluder alone
+		 * \return Number of occluder cache hits across all threads */
+		long getShadowCacheHits() const;
+		
+		/*! Getter for the light's signature
+		 * \return Hash of the light's definition in the scene file */
+		uint64_t getSignature() const;
+		
+		/*! Sets the light's signature
+		 * \param signature_ Hash of the light's definition in the scene file */
+		void setSignature(uint64_t signature_);
+		
+	protected:
+	
+		/*! Shadow ray hits closer than this distance to the surface are ignored */
+		float shadowEpsilon;
+		
 	private:
 	
+		/*! Determines whether a particular object blocks a shadow ray
+		 * \param obj The object to test against
+		 * \param shadowRay The ray travelling from the surface towards the light
+		 * \param shadowDistance The distance along the ray to the light
+		 * \return True if the object blocks the shadow ray */
+		bool occludes(Object* obj, Ray& shadowRay, float shadowDistance);
+	
 		Vec3f rgb;
+		
+		/*! Hash of the light's definition, used to detect edits between renders */
+		uint64_t signature;
+		
+		/*! Index of this light into the per-thread occluder cache */
+		int cacheSlot;
+		
+		/*! Occluder cache statistics, accumulated over all threads */
+		std::atomic<long> cacheLookups;
+		std::atomic<long> cacheHits;
+		
+		/*! Number of occluder cache slots handed out so far */
+		static std::atomic<int> numCacheSlots;
 	
 };
 
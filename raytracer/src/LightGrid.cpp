@@ -0,0 +1,135 @@
+#include "LightGrid.hpp"
+#include <algorithm>
+
+LightGrid::LightGrid(){
+	cellSize = 1.f;
+}
+
+void LightGrid::build(const std::vector<Light*>& lights, float cutoff){
+	
+	unboundedLights.clear();
+	boundedLights.clear();
+	centers.clear();
+	radiiSquared.clear();
+	cellStart.assign(1,0);
+	cellEntries.clear();
+	dims = Vec3i(0,0,0);
+	
+	// Sorting the lights by whether their influence is bounded
+	Vec3f lo( 1.e30f, 1.e30f, 1.e30f);
+	Vec3f hi(-1.e30f,-1.e30f,-1.e30f);
+	float radiusSum = 0.f;
+	for(int i = 0; i < lights.size(); i++){
+		
+		Vec3f center;
+		float radius;
+		if( !lights[i]->getInfluenceSphere(cutoff,center,radius) ){
+			unboundedLights.push_back(i);
+			continue;
+		}
+		
+		// A light which never reaches the cutoff is dropped entirely
+		if( radius <= 0.f ){
+			continue;
+		}
+		
+		boundedLights.push_back(i);
+		centers.push_back(center);
+		radiiSquared.push_back(radius*radius);
+		radiusSum += radius;
+		
+		lo = Vec3f( std::min(lo.x,center.x-radius), std::min(lo.y,center.y-radius), std::min(lo.z,center.z-radius) );
+		hi = Vec3f( std::max(hi.x,center.x+radius), std::max(hi.y,center.y+radius), std::max(hi.z,center.z+radius) );
+	}
+	
+	if( boundedLights.empty() ){
+		return;
+	}
+	
+	// Cells are about as large as an average region of influence, with at most 64 cells per axis
+	const int maxDim = 64;
+	Vec3f extent = hi - lo;
+	float largestExtent = std::max( extent.x, std::max(extent.y,extent.z) );
+	cellSize = std::max( radiusSum / boundedLights.size(), largestExtent / (maxDim-1) );
+	origin = lo;
+	dims = Vec3i( std::min( maxDim, int(extent.x/cellSize) + 1 ),
+	              std::min( maxDim, int(extent.y/cellSize) + 1 ),
+	              std::min( maxDim, int(extent.z/cellSize) + 1 ) );
+	
+	const int numCells = dims.x * dims.y * dims.z;
+	
+	// Counting the lights in each cell, then filling the cells in a second pass
+	std::vector<int> counts(numCells+1,0);
+	for(int pass = 0; pass < 2; pass++){
+		
+		for(int n = 0; n < boundedLights.size(); n++){
+			
+			float radius = sqrtf( radiiSquared[n] );
+			Vec3i cmin = cellCoords( centers[n] - Vec3f(radius,radius,radius) );
+			Vec3i cmax = cellCoords( centers[n] + Vec3f(radius,radius,radius) );
+			
+			for(int z = std::max(cmin.z,0); z <= std::min(cmax.z,dims.z-1); z++){
+				for(int y = std::max(cmin.y,0); y <= std::min(cmax.y,dims.y-1); y++){
+					for(int x = std::max(cmin.x,0); x <= std::min(cmax.x,dims.x-1); x++){
+						
+						int cell = (z*dims.y + y)*dims.x + x;
+						if( pass == 0 ){
+							counts[cell+1]++;
+						} else {
+							cellEntries[ counts[cell]++ ] = n;
+						}
+					}
+				}
+			}
+		}
+		
+		if( pass == 0 ){
+			for(int c = 0; c < numCells; c++){
+				counts[c+1] += counts[c];
+			}
+			cellStart = counts;
+			cellEntries.resize( counts[numCells] );
+		}
+	}
+	
+}
+
+void LightGrid::query(Vec3f point, std::vector<int>& lightIndices) const{
+	
+	lightIndices.insert( lightIndices.end(), unboundedLights.begin(), unboundedLights.end() );
+	
+	if( boundedLights.empty() ){
+		return;
+	}
+	
+	Vec3i c = cellCoords(point);
+	if( c.x < 0 || c.y < 0 || c.z < 0 || c.x >= dims.x || c.y >= dims.y || c.z >= dims.z ){
+		return;
+	}
+	
+	int cell = (c.z*dims.y + c.y)*dims.x + c.x;
+	for(int e = cellStart[cell]; e < cellStart[cell+1]; e++){
+		
+		int n = cellEntries[e];
+		Vec3f d = point - centers[n];
+		if( Vec3f::dot(d,d) <= radiiSquared[n] ){
+			lightIndices.push_back( boundedLights[n] );
+		}
+	}
+	
+}
+
+int LightGrid::getNumBoundedLights() const{
+	return boundedLights.size();
+}
+
+Vec3i LightGrid::getDims() const{
+	return dims;
+}
+
+Vec3i LightGrid::cellCoords(Vec3f point) const{
+	
+	Vec3f rel = (point - origin) / cellSize;
+	return Vec3i( int(floorf(rel.x)), int(floorf(rel.y)), int(floorf(rel.z)) );
+	
+}
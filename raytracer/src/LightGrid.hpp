@@ -0,0 +1,87 @@
+/**
+ * \author George Brown
+ *
+ * \file LightGrid.hpp 
+ * \brief Scenes may contain many attenuated lights, each of which only lights up a small
+ *        region around itself. A uniform grid over those regions lets the shader look up
+ *        only the lights which contribute meaningfully at a given point.
+ */
+
+#ifndef LIGHT_GRID_HPP
+#define LIGHT_GRID_HPP
+
+#include <vector>
+#include "Math.hpp"
+#include "Light.hpp"
+
+/*! \struct LightSample A light chosen to shade a point, and the weight its contribution is scaled by */
+struct LightSample {
+	
+	/*! Index of the light in the scene */
+	int light;
+	
+	/*! Scale factor applied to the light's contribution */
+	float weight;
+	
+};
+
+/*! \class LightGrid Uniform grid which stores every light with a bounded region of influence
+ *  in the cells that region overlaps. Lights with unbounded influence are kept in a separate list. */
+class LightGrid {
+	
+	public:
+	
+		/*! LightGrid constructor. The grid is empty until it is built */
+		LightGrid();
+		
+		/*! Builds the grid over the given lights
+		 * \param lights All the lights in the scene
+		 * \param cutoff Lights contributing less than this value at a point are not returned for that point */
+		void build(const std::vector<Light*>& lights, float cutoff);
+		
+		/*! Finds the lights which contribute meaningfully at a point
+		 * \param point The point to be shaded
+		 * \param lightIndices Indices of the contributing lights are appended here */
+		void query(Vec3f point, std::vector<int>& lightIndices) const;
+		
+		/*! Gets the number of lights with a bounded region of influence
+		 * \return Number of lights stored in the grid cells */
+		int getNumBoundedLights() const;
+		
+		/*! Gets the grid resolution
+		 * \return Number of cells along each axis */
+		Vec3i getDims() const;
+		
+	private:
+	
+		/*! Maps a point to the cell containing it
+		 * \param point A point in 3D space
+		 * \return Integer cell coordinates, which may lie outside of the grid */
+		Vec3i cellCoords(Vec3f point) const;
+		
+		/*! Indices of lights which are considered at every point */
+		std::vector<int> unboundedLights;
+		
+		/*! Light index, center, and squared radius of each bounded light */
+		std::vector<int> boundedLights;
+		std::vector<Vec3f> centers;
+		std::vector<float> radiiSquared;
+		
+		/*! Minimum corner of the grid */
+		Vec3f origin;
+		
+		/*! Edge length of a cell */
+		float cellSize;
+		
+		/*! Number of cells along each axis */
+		Vec3i dims;
+		
+		/*! Offset of each cell's entries in cellEntries. Cell i owns [cellStart[i], cellStart[i+1]) */
+		std::vector<int> cellStart;
+		
+		/*! Bounded light numbers, grouped by cell */
+		std::vector<int> cellEntries;
+	
+};
+
+#endif
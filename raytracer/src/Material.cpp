@@ -2,6 +2,8 @@
 #include <iostream>
 
 Material::Material(){
+	alpha = 1.f;
+	eta = 1.f;
 }
 
 	
@@ -29,6 +31,14 @@ float Material::getN() const {
 	return n;
 }
 
+float Material::getAlpha() const {
+	return alpha;
+}
+
+float Material::getEta() const {
+	return eta;
+}
+
 
 void Material::setOd( Vec3f Od_ ){
 	
@@ -88,3 +98,23 @@ void Material::setN( float n_ ){
 	
 	n = n_;
 }
+
+void Material::setAlpha( float alpha_ ){
+	
+	if( alpha_ < 0.f || alpha_ > 1.f ){
+		std::cout << "Error: Material parameter 'alpha' must be a float value between 0 and 1.\n";
+		exit(0);
+	}
+	
+	alpha = alpha_;
+}
+
+void Material::setEta( float eta_ ){
+	
+	if( eta_ < 1.f ){
+		std::cout << "Error: Material parameter 'eta' must be a float value of at least 1.\n";
+		exit(0);
+	}
+	
+	eta = eta_;
+}
@@ -5,7 +5,9 @@
  * \brief Each object can have its own unique material properties. The Blinn-Phong
  *        model is used, which requires specification of the ambient, diffuse, and
  *        specular coefficients for each object, as well as the ambient and specular
- *        intrinsic colors, and the rate of specular falloff.
+ *        intrinsic colors, and the rate of specular falloff. A material may also be
+ *        partly transparent, and have an index of refraction which makes it reflect
+ *        and refract rays.
  */
 
 #ifndef MATERIAL_HPP
@@ -48,6 +50,14 @@ class Material {
 		 * \return The coefficient for the specular falloff */
 		float getN() const;
 		
+		/*! Getter for alpha
+		 * \return The opacity, 1 for an opaque material */
+		float getAlpha() const;
+		
+		/*! Getter for eta
+		 * \return The index of refraction, 1 for a material which neither reflects nor bends rays */
+		float getEta() const;
+		
 		/*! Sets the intrinsic color of the object
 		 *  \param Od_ The color of the object as an RGB tuple */
 		void setOd( Vec3f Od_ );
@@ -71,6 +81,14 @@ class Material {
 		/*! Sets the coefficient for the specular falloff
 		 * \param n_ The coefficient for the specular falloff */
 		void setN( float n_ );
+		
+		/*! Sets the opacity
+		 * \param alpha_ The opacity (between 0-1) */
+		void setAlpha( float alpha_ );
+		
+		/*! Sets the index of refraction
+		 * \param eta_ The index of refraction (at least 1) */
+		void setEta( float eta_ );
 	
 	private:
 	
@@ -91,6 +109,12 @@ class Material {
 		
 		/*! Coefficient for the specular falloff */
 		float n;
+		
+		/*! Opacity. The rest of the light which is not reflected passes through */
+		float alpha;
+		
+		/*! Index of refraction */
+		float eta;
 	
 };
 
@@ -0,0 +1,96 @@
+#include "MemoryFramebuffer.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+
+MemoryFramebuffer::MemoryFramebuffer(int width_, int height_, Format format_, const std::string& filename_)
+	: Framebuffer(width_,height_), format(format_), filename(filename_) {
+		
+	const size_t numValues = size_t(width) * height * 3;
+	if( format == FLOAT ){
+		floatData.resize( numValues );
+	} else if( format == HALF ){
+		halfData.resize( numValues );
+	} else {
+		byteData.resize( numValues );
+	}
+	
+}
+
+void MemoryFramebuffer::writeTile(int x0, int y0, int w, int h, const Vec3f* colors){
+	
+	for(int y = y0; y < y0+h; y++){
+		for(int x = x0; x < x0+w; x++){
+			
+			const Vec3f& rgb = *colors++;
+			const size_t i = ( size_t(y) * width + x ) * 3;
+			
+			if( format == FLOAT ){
+				floatData[i] = rgb.x;
+				floatData[i+1] = rgb.y;
+				floatData[i+2] = rgb.z;
+			} else if( format == HALF ){
+				halfData[i] = Half::fromFloat(rgb.x);
+				halfData[i+1] = Half::fromFloat(rgb.y);
+				halfData[i+2] = Half::fromFloat(rgb.z);
+			} else {
+				byteData[i] = toByte(rgb.x);
+				byteData[i+1] = toByte(rgb.y);
+				byteData[i+2] = toByte(rgb.z);
+			}
+			
+		}
+	}
+	
+}
+
+Vec3f MemoryFramebuffer::getPixel(int x, int y) const{
+	
+	const size_t i = ( size_t(y) * width + x ) * 3;
+	
+	if( format == FLOAT ){
+		return Vec3f( floatData[i], floatData[i+1], floatData[i+2] );
+	} else if( format == HALF ){
+		return Vec3f( Half::toFloat(halfData[i]), Half::toFloat(halfData[i+1]), Half::toFloat(halfData[i+2]) );
+	} else {
+		return Vec3f( byteData[i] / 255.f, byteData[i+1] / 255.f, byteData[i+2] / 255.f );
+	}
+	
+}
+
+void MemoryFramebuffer::finish(){
+	
+	std::cout << "Output file: " << filename << std::endl;
+	
+	std::ofstream outputfile( filename.c_str() );
+	
+	if( outputfile.is_open() ){
+		
+		// The standard ppm format.
+		outputfile << "P3\n";
+		outputfile << "# ppm data for an image with a given width, height, and pixel values from 0-255 \n";
+		outputfile << width << " " << height << std::endl;
+		outputfile << 255 << std::endl;
+		
+		// Looping through the image data and writing the rgb values.  Each pixel gets its own line.
+		// Pixels stored as bytes are written as they are, since converting them back to floats
+		// and then to bytes again could change them
+		for(int y = 0; y < height; y++){
+			for(int x = 0; x < width; x++){
+				if( format == RGB8 ){
+					const size_t i = ( size_t(y) * width + x ) * 3;
+					outputfile << int(byteData[i]) << " " << int(byteData[i+1]) << " " << int(byteData[i+2]) << "\n";
+				} else {
+					Vec3f rgb = getPixel(x,y);
+					outputfile << int(toByte(rgb.x)) << " " << int(toByte(rgb.y)) << " " << int(toByte(rgb.z)) << "\n";
+				}
+			}
+		}
+		
+	} else {
+		std::cout << "Error: Failed to open an output file with the given filename.\n";
+		exit(0);
+	}
+	
+}
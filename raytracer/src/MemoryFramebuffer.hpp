@@ -0,0 +1,70 @@
+/**
+ * \author George Brown
+ *
+ * \file MemoryFramebuffer.hpp 
+ * \brief A framebuffer which holds the whole image in memory until it is saved.
+ *        Pixels can be stored at full float precision or in a more compact format.
+ */
+
+#ifndef MEMORY_FRAMEBUFFER_HPP
+#define MEMORY_FRAMEBUFFER_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Framebuffer.hpp"
+#include "Half.hpp"
+
+/*! \class MemoryFramebuffer Class which stores every pixel of the image and writes them all to a
+ *  plain text PPM file when the image is finished */
+class MemoryFramebuffer : public Framebuffer {
+	
+	public:
+		
+		/*! The ways a pixel can be stored */
+		enum Format {
+			FLOAT,  /*!< Three 32-bit floats, 12 bytes per pixel */
+			HALF,   /*!< Three 16-bit half floats, 6 bytes per pixel */
+			RGB8    /*!< The three 0-255 values written to the PPM file, 3 bytes per pixel */
+		};
+		
+		/*! MemoryFramebuffer constructor
+		 * \param width_ The width of the image in pixels
+		 * \param height_ The height of the image in pixels
+		 * \param format_ How each pixel is stored
+		 * \param filename_ The name of the PPM file the image is saved to */
+		MemoryFramebuffer(int width_, int height_, Format format_, const std::string& filename_);
+		
+		/*! Stores a finished rectangle of pixels
+		 * \param x0 The column of the tile's upper left pixel
+		 * \param y0 The row of the tile's upper left pixel
+		 * \param w The width of the tile in pixels
+		 * \param h The height of the tile in pixels
+		 * \param colors The tile's colors in scanline order, w*h of them */
+		void writeTile(int x0, int y0, int w, int h, const Vec3f* colors);
+		
+		/*! Saves the image to the PPM file */
+		void finish();
+		
+		/*! Reads back a stored pixel
+		 * \param x The column of the pixel
+		 * \param y The row of the pixel
+		 * \return The pixel's color, as precise as the storage format allows */
+		Vec3f getPixel(int x, int y) const;
+		
+	private:
+		
+		/*! How each pixel is stored */
+		Format format;
+		
+		/*! The name of the PPM file */
+		std::string filename;
+		
+		/*! Pixel storage. Only the vector for the chosen format is used */
+		std::vector<float> floatData;
+		std::vector<uint16_t> halfData;
+		std::vector<unsigned char> byteData;
+		
+};
+
+#endif
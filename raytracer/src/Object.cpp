@@ -3,6 +3,11 @@
 Object::Object(Material* material_, Texture* texture_){
 	material = material_;
 	texture = texture_;
+	signature = 0;
+}
+
+bool Object::canOccludeItself() const{
+	return false;
 }
 
 Material* Object::getMaterial(){
@@ -20,3 +25,11 @@ void Object::setMaterial(Material* material_){
 void Object::setTexture(Texture* texture_){
 	texture = texture_;
 }
+
+uint64_t Object::getSignature() const{
+	return signature;
+}
+
+void Object::setSignature(uint64_t signature_){
+	signature = signature_;
+}
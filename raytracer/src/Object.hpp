@@ -9,6 +9,7 @@
 #ifndef OBJECT_HPP
 #define OBJECT_HPP
 
+#include <cstdint>
 #include "Math.hpp"
 #include "Material.hpp"
 #include "Texture.hpp"
@@ -26,6 +27,9 @@ class Object {
 		 * \param material_ The material information for the object
 		 * \param texture_ The texture to apply to the object (optional) */
 		Object(Material* material_, Texture* texture_ = 0);
+		
+		/*! Object destructor. Scene objects may be deleted through a pointer to Object */
+		virtual ~Object() {}
 	
 	
 		/*! Determines whether a ray intersects the object. If so, returns a scalar t such that
@@ -36,10 +40,26 @@ class Object {
 		 * \return Boolean true if intersecting, else false. */
 		virtual bool intersect(Ray& ray, RayPayload& rayPayload) = 0;
 		
+		/*! Determines whether a ray hits the object at a distance t with tmin <= t < tmax. Only the
+		 *  geometry is tested, so this is the cheaper test for shadow rays which need any hit at all.
+		 *  When the ray hits the object more than once in the interval, the nearest hit is returned.
+		 * \param ray The ray which the intersection check is performed with
+		 * \param tmin The smallest distance along the ray which counts as a hit
+		 * \param tmax Hits at this distance or further away are ignored
+		 * \param t Set to the distance along the ray to the hit
+		 * \return Boolean true if intersecting within the interval, else false. */
+		virtual bool intersectInterval(Ray& ray, float tmin, float tmax, float& t) = 0;
+		
 		/*! Determines unit normal at a particular point on the surface of an object.
 		 * \param pointOnSurface The point on the surface of the object in which to compute the normal.
+		 * \param rayPayload Payload of the ray which hit the object at that point, as filled in by intersect
 		 * \return Unit surface normal at point on surface */
-		virtual Vec3f getUnitSurfaceNormal(Vec3f pointOnSurface) = 0;
+		virtual Vec3f getUnitSurfaceNormal(Vec3f pointOnSurface, const RayPayload& rayPayload) = 0;
+		
+		/*! Checks whether one part of the object may cast a shadow on another part, as faces of a mesh may.
+		 *  Shadow rays are otherwise never tested against the object they leave.
+		 * \return True if the object can shadow itself, false by default */
+		virtual bool canOccludeItself() const;
 		
 		/*! Getter for object's material
 		 * \return Pointer to the object's material */
@@ -57,6 +77,14 @@ class Object {
 		 * \param texture_ Pointer to the texture to assign to the object */
 		void setTexture(Texture* texture_);
 		
+		/*! Getter for the object's signature
+		 * \return Hash of the material and texture the object was given in the scene file */
+		uint64_t getSignature() const;
+		
+		/*! Sets the object's signature
+		 * \param signature_ Hash of the material and texture the object was given in the scene file */
+		void setSignature(uint64_t signature_);
+		
 	protected:
 	
 		/*! Material data for Blinn-Phong */
@@ -64,6 +92,9 @@ class Object {
 		
 		/*! Texture to apply */
 		Texture* texture;
+		
+		/*! Hash of the object's shading parameters, used to detect edits between renders */
+		uint64_t signature;
 	
 };
 
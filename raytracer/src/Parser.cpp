@@ -20,6 +20,8 @@ Scene Parser::parse(int argc, char** argv){
 	std::string filename( argv[1] );
 	std::cout << "Input file: " << filename << std::endl;
 	scene.setSceneName( removeSuffix(filename) );
+	scene.setRenderOptions( RenderOptions::parse(argc,argv) );
+	scene.setTextureCache( new TextureCache( long(scene.getRenderOptions().textureCacheMb) * 1024 * 1024 ) );
 
 	// Create a filestream for reading the text file, and open it.
 	// The is_open call will return false if there was a problem.
@@ -31,6 +33,17 @@ Scene Parser::parse(int argc, char** argv){
 		
 		Material* material = 0;
 		Texture* texture = 0;
+		
+		// Textures which have already been loaded, by filename, so that each file is only loaded once
+		std::unordered_map<std::string, Texture*> textures;
+		
+		// Signatures of the scene file, which let a later render tell what was edited.
+		// Objects are identified by their material and texture lines, lights by their own line,
+		// and everything else is folded into one signature for the view and one for the geometry.
+		uint64_t viewSignature = 0;
+		uint64_t geometrySignature = 0;
+		uint64_t materialSignature = 0;
+		uint64_t textureSignature = 0;
 				
 		//Vec3f mtlColor = Vec3f(0,0,0);
 
@@ -49,12 +62,14 @@ Scene Parser::parse(int argc, char** argv){
 
 			// Eye position
 			if( var == "eye" ){
+				viewSignature = TileCache::hashCombine( viewSignature, TileCache::hashString(line) );
 				Vec3f pos = parseVec3f(var,ss);
 				scene.setEyePos( pos );
 			}
 			
 			// Viewing direction vector
 			else if( var == "viewdir" ){
+				viewSignature = TileCache::hashCombine( viewSignature, TileCache::hashString(line) );
 				Vec3f viewDir = parseVec3f(var,ss);
 				if( Vec3f::dot(viewDir,viewDir) < 1.e-6 ){
 					std::cout << "Error: viewdir is too close to 0 magnitude. Please specify a unit vector.\n";
@@ -66,6 +81,7 @@ Scene Parser::parse(int argc, char** argv){
 			
 			// The "Up" direction
 			else if( var == "updir" ){
+				viewSignature = TileCache::hashCombine( viewSignature, TileCache::hashString(line) );
 				Vec3f upDir = parseVec3f(var,ss);
 				if( Vec3f::dot(upDir,upDir) < 1.e-6 ){
 					std::cout << "Error: updir is too close to 0 magnitude. Please specify a unit vector.\n";
@@ -77,6 +93,7 @@ Scene Parser::parse(int argc, char** argv){
 			
 			// Field of view in vertical direction, in degrees
 			else if( var == "fovv" ){
+				viewSignature = TileCache::hashCombine( viewSignature, TileCache::hashString(line) );
 				float fovv = parseFloat(var,ss);
 				
 				if( fovv < 0  || fovv >= 180.f ){
@@ -89,12 +106,14 @@ Scene Parser::parse(int argc, char** argv){
 			
 			// The width and height of the image
 			else if( var == "imsize" ){
+				viewSignature = TileCache::hashCombine( viewSignature, TileCache::hashString(line) );
 				Vec2i imSize = parseVec2i(var,ss);
 				scene.setEnvDims( imSize );
 			}
 			
 			// Background color
 			else if( var == "bkgcolor" ){
+				viewSignature = TileCache::hashCombine( viewSignature, TileCache::hashString(line) );
 				Vec3f bkgColor = parseVec3f(var,ss);
 				scene.setBkgColor( bkgColor );
 			}
@@ -107,6 +126,7 @@ Scene Parser::parse(int argc, char** argv){
 				float ka, kd, ks, n;
 				
 				ss >> Odr >> Odg >> Odb >> Osr >> Osg >> Osb >> ka >> kd >> ks >> n;
+				materialSignature = TileCache::hashString(line);
 				
 				material = new Material();
 				material->setOd( Vec3f(Odr,Odg,Odb) );
@@ -116,14 +136,27 @@ Scene Parser::parse(int argc, char** argv){
 				material->setKs( ks );
 				material->setN( n );
 				
+				// Opacity and index of refraction are optional
+				float alpha, eta;
+				if( ss >> alpha ){
+					material->setAlpha( alpha );
+					if( ss >> eta ){
+						material->setEta( eta );
+					}
+				}
+				
 			}
 			
 			else if( var == "texture" ){
 				
 				std::string textureFilename;
 				ss >> textureFilename;
-				texture = new Texture();
-				texture->loadFromPpm(textureFilename);
+				if( textures.count(textureFilename) == 0 ){
+					textures[textureFilename] = new Texture( scene.getTextureCache() );
+					textures[textureFilename]->loadFromPpm( textureFilename, scene.getRenderOptions().textureTileDir );
+				}
+				texture = textures[textureFilename];
+				textureSignature = TileCache::hashString(line);
 				
 			}
 			
@@ -133,8 +166,11 @@ Scene Parser::parse(int argc, char** argv){
 				ss >> x >> y >> z >> r;
 				Vec3f pos(x,y,z);
 				Sphere* sphere = new Sphere( pos, r, material, texture);
+				sphere->setSignature( TileCache::hashCombine( materialSignature, textureSignature ) );
 				scene.addObject( sphere );
+				geometrySignature = TileCache::hashCombine( geometrySignature, TileCache::hashString(line) );
 				texture = 0;
+				textureSignature = 0;
 			}
 			
 			else if( var == "light" ){
@@ -146,10 +182,14 @@ Scene Parser::parse(int argc, char** argv){
 				ss >> x >> y >> z >> w >> r >> g >> b;
 				
 				if( w == 1 ){
-					scene.addPointLight( new PointLight( Vec3f(x,y,z) , Vec3f(r,g,b) ) );
+					PointLight* light = new PointLight( Vec3f(x,y,z) , Vec3f(r,g,b) );
+					light->setSignature( TileCache::hashString(line) );
+					scene.addPointLight( light );
 				} else if( w == 0 ){
 					Vec3f dir = Vec3f::normalize( Vec3f(x,y,z) );
-					scene.addDirectionalLight( new DirectionalLight( dir , Vec3f(r,g,b) ) );
+					DirectionalLight* light = new DirectionalLight( dir , Vec3f(r,g,b) );
+					light->setSignature( TileCache::hashString(line) );
+					scene.addDirectionalLight( light );
 				} else {
 					std::cout << "Error: Did not correctly specify the type of light. \n";
 					std::cout << "Set the 'w' parameter to 0 for a point light, or 1 for a directional light.\n";
@@ -158,19 +198,43 @@ Scene Parser::parse(int argc, char** argv){
 			
 			}
 			
+			// Point light with attenuation coefficients c1, c2, c3
+			else if( var == "attlight" ){
+			
+				float x=0.f, y=0.f, z=0.f;
+				int w = -1;
+				float r = 0.f, g = 0.f, b = 0.f;
+				float c1 = -1.f, c2 = -1.f, c3 = -1.f;
+				
+				ss >> x >> y >> z >> w >> r >> g >> b >> c1 >> c2 >> c3;
+				
+				if( w != 1 ){
+					std::cout << "Error: Only point lights may be attenuated. Set the 'w' parameter of 'attlight' to 1.\n";
+					exit(0);
+				}
+				
+				PointLight* light = new PointLight( Vec3f(x,y,z) , Vec3f(r,g,b), Vec3f(c1,c2,c3) );
+				light->setSignature( TileCache::hashString(line) );
+				scene.addPointLight( light );
+			
+			}
+			
 			else if( var == "v" ){
 				Vec3f pos = parseVec3f(var,ss);
 				scene.addVert(pos);
+				geometrySignature = TileCache::hashCombine( geometrySignature, TileCache::hashString(line) );
 			}
 			
 			else if( var == "vt" ){
 				Vec2f coords = parseVec2f(var,ss);
 				scene.addTextureCoords( coords );
+				geometrySignature = TileCache::hashCombine( geometrySignature, TileCache::hashString(line) );
 			}
 			
 			else if( var == "vn" ){
 				Vec3f normal = parseVec3f(var,ss);
 				scene.addNormal( normal );
+				geometrySignature = TileCache::hashCombine( geometrySignature, TileCache::hashString(line) );
 			}
 			
 			else if( var == "f" ){
@@ -179,7 +243,9 @@ Scene Parser::parse(int argc, char** argv){
 				Vec3i v2;
 				Vec3i v3;
 				parseFace(v1,v2,v3,ss);
-				scene.addTriangle(v1,v2,v3,material,texture);
+				Triangle* tri = scene.addTriangle(v1,v2,v3,material,texture);
+				tri->setSignature( TileCache::hashCombine( materialSignature, textureSignature ) );
+				geometrySignature = TileCache::hashCombine( geometrySignature, TileCache::hashString(line) );
 				
 			}
 			
@@ -197,6 +263,9 @@ Scene Parser::parse(int argc, char** argv){
 
 		} // end parse line
 
+		scene.setViewSignature( viewSignature );
+		scene.setGeometrySignature( geometrySignature );
+
 	}
 	else { std::cerr << "**Error: Could not open file " << filename << std::endl; exit(0); }
 	
@@ -212,6 +281,7 @@ Scene Parser::parse(int argc, char** argv){
 	
 	
 	scene.verifySetup();
+	scene.prepare();
 	
 	return scene;
 	
@@ -17,11 +17,14 @@
 #include "Texture.hpp"
 #include "DirectionalLight.hpp"
 #include "PointLight.hpp"
+#include "RenderOptions.hpp"
+#include "TileCache.hpp"
 #include <fstream>
 #include <sstream>
 #include <utility>
 #include <cstdlib>
 #include <tuple>
+#include <unordered_map>
 
 /*! \class Parser Parser reads the input file, parses it, and produces the scene */
 class Parser {
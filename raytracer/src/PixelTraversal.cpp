@@ -0,0 +1,124 @@
+#include "PixelTraversal.hpp"
+#include <algorithm>
+#include <utility>
+
+PixelTraversal::PixelTraversal(int width_, int height_, const std::string& order_, int tileSize_){
+	
+	order = order_;
+	
+	// Scanline order visits whole rows, every other order visits square tiles
+	int blockWidth = ( order == "scanline" ) ? width_ : tileSize_;
+	int blockHeight = ( order == "scanline" ) ? 1 : tileSize_;
+	
+	int cols = ( width_ + blockWidth - 1 ) / blockWidth;
+	int rows = ( height_ + blockHeight - 1 ) / blockHeight;
+	std::vector<Vec2i> cells = orderCells( cols, rows );
+	
+	for(int c = 0; c < cells.size(); c++){
+		PixelBlock block;
+		block.x0 = cells[c].x * blockWidth;
+		block.y0 = cells[c].y * blockHeight;
+		block.width = std::min( blockWidth, width_ - block.x0 );
+		block.height = std::min( blockHeight, height_ - block.y0 );
+		blocks.push_back(block);
+	}
+	
+	blockOffsets = orderCells( blockWidth, blockHeight );
+	
+}
+
+bool PixelTraversal::isValidOrder(const std::string& order_){
+	return order_ == "scanline" || order_ == "tiles" || order_ == "hilbert" || order_ == "morton";
+}
+
+// Hilbert curve index by rotating quadrants, from Hacker's Delight //
+uint64_t PixelTraversal::hilbertIndex(uint32_t n, uint32_t x, uint32_t y){
+	
+	uint64_t d = 0;
+	for(uint32_t s = n/2; s > 0; s /= 2){
+		
+		uint32_t rx = ( x & s ) > 0;
+		uint32_t ry = ( y & s ) > 0;
+		d += uint64_t(s) * s * ( (3 * rx) ^ ry );
+		
+		// Rotating the quadrant so that the curve inside it starts and ends in the right corners
+		if( ry == 0 ){
+			if( rx == 1 ){
+				x = s-1 - x;
+				y = s-1 - y;
+			}
+			std::swap(x,y);
+		}
+		x &= s-1;
+		y &= s-1;
+		
+	}
+	return d;
+	
+}
+
+uint64_t PixelTraversal::mortonIndex(uint32_t x, uint32_t y){
+	
+	uint64_t d = 0;
+	for(int bit = 0; bit < 32; bit++){
+		d |= uint64_t( (x >> bit) & 1 ) << (2*bit);
+		d |= uint64_t( (y >> bit) & 1 ) << (2*bit + 1);
+	}
+	return d;
+	
+}
+
+int PixelTraversal::getNumBlocks() const{
+	return blocks.size();
+}
+
+const PixelBlock& PixelTraversal::getBlock(int b) const{
+	return blocks[b];
+}
+
+void PixelTraversal::getPixels(int b, std::vector<Vec2i>& pixels) const{
+	
+	const PixelBlock& block = blocks[b];
+	
+	pixels.clear();
+	for(int p = 0; p < blockOffsets.size(); p++){
+		if( blockOffsets[p].x < block.width && blockOffsets[p].y < block.height ){
+			pixels.push_back( Vec2i( block.x0 + blockOffsets[p].x, block.y0 + blockOffsets[p].y ) );
+		}
+	}
+	
+}
+
+std::vector<Vec2i> PixelTraversal::orderCells(int cols, int rows) const{
+	
+	std::vector<Vec2i> cells;
+	if( order == "scanline" || order == "tiles" ){
+		for(int y = 0; y < rows; y++){
+			for(int x = 0; x < cols; x++){
+				cells.push_back( Vec2i(x,y) );
+			}
+		}
+		return cells;
+	}
+	
+	// The curves fill a square grid with a power of two edge, which is cut back to the real grid
+	uint32_t n = 1;
+	while( n < cols || n < rows ){
+		n *= 2;
+	}
+	
+	std::vector< std::pair<uint64_t,int> > keys;
+	for(int y = 0; y < rows; y++){
+		for(int x = 0; x < cols; x++){
+			uint64_t key = ( order == "hilbert" ) ? hilbertIndex(n,x,y) : mortonIndex(x,y);
+			keys.push_back( std::make_pair( key, y*cols + x ) );
+		}
+	}
+	std::sort( keys.begin(), keys.end() );
+	
+	for(int k = 0; k < keys.size(); k++){
+		cells.push_back( Vec2i( keys[k].second % cols, keys[k].second / cols ) );
+	}
+	return cells;
+	
+}
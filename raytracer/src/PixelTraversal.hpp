@@ -0,0 +1,96 @@
+/**
+ * \author George Brown
+ *
+ * \file PixelTraversal.hpp
+ * \brief The order in which pixels are traced decides how much of the scene data loaded for
+ *        one pixel is still cached when its neighbours are traced. The image is cut into blocks,
+ *        either rows or square tiles, which are visited in scanline, Hilbert, or Morton order,
+ *        and the pixels inside each block are visited in the same order.
+ */
+
+#ifndef PIXEL_TRAVERSAL_HPP
+#define PIXEL_TRAVERSAL_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Math.hpp"
+
+/*! \struct PixelBlock A rectangle of pixels which is traced and handed to the framebuffer as a whole */
+struct PixelBlock {
+	
+	/*! Top left pixel of the block */
+	int x0;
+	int y0;
+	
+	/*! Size of the block in pixels */
+	int width;
+	int height;
+	
+};
+
+/*! \class PixelTraversal Class which lists the blocks of an image, and the pixels in each block, in traversal order */
+class PixelTraversal {
+	
+	public:
+		
+		/*! PixelTraversal constructor
+		 * \param width_ Image width in pixels
+		 * \param height_ Image height in pixels
+		 * \param order_ "scanline" to visit the image row by row, or "tiles", "hilbert", or "morton"
+		 *        to visit square tiles in scanline, Hilbert curve, or Morton (Z) curve order
+		 * \param tileSize_ Edge length of a tile in pixels */
+		PixelTraversal(int width_, int height_, const std::string& order_, int tileSize_);
+		
+		/*! Checks whether a traversal order is known
+		 * \param order_ The name of the order
+		 * \return True if the order may be given to the constructor */
+		static bool isValidOrder(const std::string& order_);
+		
+		/*! Computes the position of a point along a Hilbert curve which fills a square grid
+		 * \param n Edge length of the grid, a power of two
+		 * \param x Column of the point
+		 * \param y Row of the point
+		 * \return Distance along the curve */
+		static uint64_t hilbertIndex(uint32_t n, uint32_t x, uint32_t y);
+		
+		/*! Computes the position of a point along a Morton (Z) curve
+		 * \param x Column of the point
+		 * \param y Row of the point
+		 * \return Distance along the curve */
+		static uint64_t mortonIndex(uint32_t x, uint32_t y);
+		
+		/*! Gets the number of blocks in the image
+		 * \return Number of blocks */
+		int getNumBlocks() const;
+		
+		/*! Getter for a block
+		 * \param b Position of the block in traversal order
+		 * \return The block */
+		const PixelBlock& getBlock(int b) const;
+		
+		/*! Lists the pixels of a block in traversal order
+		 * \param b Position of the block in traversal order
+		 * \param pixels Set to the coordinates of the block's pixels */
+		void getPixels(int b, std::vector<Vec2i>& pixels) const;
+		
+	private:
+		
+		/*! Sorts grid cells along the curve of the traversal order
+		 * \param cols Number of columns in the grid
+		 * \param rows Number of rows in the grid
+		 * \return Coordinates of every cell, in traversal order */
+		std::vector<Vec2i> orderCells(int cols, int rows) const;
+		
+		/*! Name of the traversal order */
+		std::string order;
+		
+		/*! Blocks in traversal order */
+		std::vector<PixelBlock> blocks;
+		
+		/*! Offsets of the pixels of a full block from its top left pixel, in traversal order */
+		std::vector<Vec2i> blockOffsets;
+		
+};
+
+#endif
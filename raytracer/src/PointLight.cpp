@@ -1,7 +1,16 @@
 #include "PointLight.hpp"
+#include <algorithm>
 
-PointLight::PointLight(Vec3f pos_, Vec3f rgb_)
-	: Light(rgb_), pos(pos_) {
+PointLight::PointLight(Vec3f pos_, Vec3f rgb_, Vec3f attenuation_)
+	: Light(rgb_), pos(pos_), attenuation(attenuation_) {
+	
+	if( attenuation.x < 0.f || attenuation.y < 0.f || attenuation.z < 0.f ||
+	    attenuation.x + attenuation.y + attenuation.z <= 0.f ){
+		std::cout << "Error: The attenuation coefficients of a light must be nonnegative and not all 0.\n";
+		exit(0);
+	}
+	
+	shadowEpsilon = 0.005f;
 }
 
 // Computes the L vector used in Phong illumination
@@ -9,36 +18,48 @@ Vec3f PointLight::computeL(Vec3f intersectPoint_){
 	return Vec3f::normalize( pos - intersectPoint_ );
 }
 
-
-// Determines whether the light is blocked by an object, with respect to a given position on another object's surface
-bool PointLight::isBlocked(const std::vector<Object*>& objects_, Object* thisObj_, Vec3f surfacePos_){
+// Computes the attenuation of the light at a given point
+float PointLight::computeAttenuation(Vec3f intersectPoint_){
 	
-	Vec3f rayDir = Vec3f::normalize(pos - surfacePos_);
-	float lightDist = Vec3f::norm(pos - surfacePos_);
-
-	Object* nearestObj = 0;
-	float tmin = 1000000.f;
-
-	Ray shadowRay(surfacePos_,rayDir);
-	RayPayload rayPayload;
+	float d = Vec3f::norm( pos - intersectPoint_ );
+	return 1.f / ( attenuation.x + attenuation.y*d + attenuation.z*d*d );
+	
+}
 
-	for(int i = 0; i < objects_.size(); i++){
-		if( (objects_[i] != thisObj_) && objects_[i]->intersect(shadowRay,rayPayload) ){
-			if( rayPayload.getDistance() > 0.005 ){
-				rayPayload.setObject( objects_[i] );
-			}
-		}
+// Solves c1 + c2*d + c3*d^2 = maxRgb / cutoff for the distance d where the light becomes negligible
+bool PointLight::getInfluenceSphere(float cutoff, Vec3f& center, float& radius){
+	
+	Vec3f rgb = getRGB();
+	float maxRgb = std::max( rgb.x, std::max(rgb.y,rgb.z) );
+	
+	if( cutoff <= 0.f || (attenuation.y == 0.f && attenuation.z == 0.f && attenuation.x * cutoff <= maxRgb) ){
+		return false;
 	}
 	
-	if( rayPayload.getObject() != 0 && rayPayload.getObject() != NULL ){
-		
-		return true;
+	center = pos;
+	
+	float k = attenuation.x - maxRgb / cutoff;
+	if( k >= 0.f ){
+		radius = 0.f;
+	} else if( attenuation.z > 0.f ){
+		radius = ( -attenuation.y + sqrtf( attenuation.y*attenuation.y - 4.f*attenuation.z*k ) ) / (2.f*attenuation.z);
+	} else {
+		radius = -k / attenuation.y;
 	}
 	
-	return false;
+	return true;
 	
 }
 
+// Computes the shadow ray which travels from a point on a surface towards the light
+Ray PointLight::computeShadowRay(Vec3f surfacePos_){
+	return Ray(surfacePos_, pos - surfacePos_);
+}
+
+float PointLight::computeShadowDistance(Vec3f surfacePos_){
+	return Vec3f::norm( pos - surfacePos_ );
+}
+
 Vec3f PointLight::getPos() const{
 	return pos;
 }
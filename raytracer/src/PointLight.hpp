@@ -19,21 +19,36 @@ class PointLight : public Light {
 	
 		/*! PointLight constructor
 		 * \param pos_ The position of the point light in space
-		 * \param rgb_ The color of the point light, in RGB */
-		PointLight(Vec3f pos_, Vec3f rgb_);
+		 * \param rgb_ The color of the point light, in RGB
+		 * \param attenuation_ Constant, linear, and quadratic attenuation coefficients (c1,c2,c3) */
+		PointLight(Vec3f pos_, Vec3f rgb_, Vec3f attenuation_ = Vec3f(1.f,0.f,0.f));
 		
 		/*! Computes the L vector used in Phong illumination
 		 * \param intersectPoint The point of intersection
 		 * \return The L vector used in Phong illumination */
 		Vec3f computeL(Vec3f intersectPoint_);
 		
-		/*! Determines whether the light is blocked by an object, with respect 
-		 *  to a given position on another object's surface
-		 *  \param objects_ Container of pointers to all the objects in the scene
-		 *  \param thisObj_ Pointer to the object in question
+		/*! Computes the attenuation 1 / (c1 + c2*d + c3*d^2) at distance d from the light
+		 * \param intersectPoint_ The point being illuminated
+		 * \return The attenuation factor */
+		float computeAttenuation(Vec3f intersectPoint_);
+		
+		/*! Determines the sphere outside of which the attenuated light contributes less than a cutoff value.
+		 * \param cutoff The smallest contribution which is considered meaningful
+		 * \param center Set to the position of the light
+		 * \param radius Set to the distance at which the contribution falls to the cutoff
+		 * \return True if the light's influence is bounded, false if it reaches every point */
+		bool getInfluenceSphere(float cutoff, Vec3f& center, float& radius);
+		
+		/*! Computes the shadow ray which travels from a point on a surface towards the light
 		 *  \param surfacePos_ Position on the surface of the object in question
-		 *  \return Boolean flag which is true if the light is blocked, false otherwise */
-		bool isBlocked(const std::vector<Object*>& objects_, Object* thisObj_, Vec3f surfacePos_);
+		 *  \return The shadow ray */
+		Ray computeShadowRay(Vec3f surfacePos_);
+		
+		/*! Computes the distance from a point on a surface to the light
+		 *  \param surfacePos_ Position on the surface of the object in question
+		 *  \return The distance to the light */
+		float computeShadowDistance(Vec3f surfacePos_);
 		
 		/*! Gets the position of the point light
 		 * \return The position of the point light */
@@ -42,6 +57,9 @@ class PointLight : public Light {
 	private:
 	
 		Vec3f pos;
+		
+		/*! Constant, linear, and quadratic attenuation coefficients */
+		Vec3f attenuation;
 	
 };
 
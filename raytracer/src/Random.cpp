@@ -0,0 +1,24 @@
+#include "Random.hpp"
+
+Random::Random(uint64_t seed, uint64_t stream){
+	state = 0;
+	inc = (stream << 1u) | 1u;
+	nextUInt();
+	state += seed;
+	nextUInt();
+}
+
+uint32_t Random::nextUInt(){
+	
+	uint64_t oldState = state;
+	state = oldState * 6364136223846793005ULL + inc;
+	uint32_t xorShifted = uint32_t( ((oldState >> 18u) ^ oldState) >> 27u );
+	uint32_t rot = uint32_t( oldState >> 59u );
+	return (xorShifted >> rot) | (xorShifted << ((-rot) & 31));
+	
+}
+
+float Random::nextFloat(){
+	// 24 random bits give every representable float in [0,1) at that spacing
+	return (nextUInt() >> 8) * (1.f / 16777216.f);
+}
@@ -0,0 +1,43 @@
+/**
+ * \author George Brown
+ *
+ * \file Random.hpp 
+ * \brief A small, fast pseudo-random number generator. Every pixel seeds its own
+ *        generator so that stochastic rendering decisions are reproducible and
+ *        independent of the order in which pixels are rendered.
+ */
+
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+
+/*! \class Random Pseudo-random number generator (PCG32) with an explicit seed */
+class Random {
+	
+	public:
+	
+		/*! Random constructor
+		 * \param seed The seed, e.g. a pixel index
+		 * \param stream Selects one of many independent sequences for the same seed */
+		Random(uint64_t seed, uint64_t stream = 0);
+		
+		/*! Generates the next random integer
+		 * \return Uniformly distributed 32-bit unsigned integer */
+		uint32_t nextUInt();
+		
+		/*! Generates the next random float
+		 * \return Uniformly distributed float in [0,1) */
+		float nextFloat();
+		
+	private:
+	
+		/*! Generator state */
+		uint64_t state;
+		
+		/*! Stream increment, always odd */
+		uint64_t inc;
+	
+};
+
+#endif
@@ -6,6 +6,7 @@ RayPayload::RayPayload(){
 	material = 0;
 	distance = 100000000;
 	textureColor = Vec3f(-1.f,-1.f,-1.f);
+	primitive = -1;
 	
 }
 
@@ -29,6 +30,14 @@ Vec3f RayPayload::getTextureColor() const{
 float RayPayload::getDistance() const{
 	return distance;
 }
+
+Vec3f RayPayload::getBarycentricCoords() const{
+	return baryCoords;
+}
+		
+int RayPayload::getPrimitive() const{
+	return primitive;
+}
 		
 void RayPayload::setObject(Object* object_){
 	object = object_;
@@ -49,3 +58,11 @@ void RayPayload::setTextureColor(Vec3f textureColor_){
 void RayPayload::setDistance(float distance_){
 	distance = distance_;
 }
+
+void RayPayload::setBarycentricCoords(Vec3f baryCoords_){
+	baryCoords = baryCoords_;
+}
+
+void RayPayload::setPrimitive(int primitive_){
+	primitive = primitive_;
+}
\ No newline at end of file
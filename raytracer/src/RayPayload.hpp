@@ -50,6 +50,16 @@ class RayPayload {
 		float getDistance() const;
 		
 		
+		/*! Get the barycentric coordinates of the intersection, for objects made of triangles
+		 * \return The barycentric coordinates as a 3D float vec */
+		Vec3f getBarycentricCoords() const;
+		
+		
+		/*! Get the index of the face which was hit, for objects made of many faces
+		 * \return Index of the face, or -1 if not set */
+		int getPrimitive() const;
+		
+		
 		/*! Set the RayPayload object pointer
 		 * \param object_ Pointer to the object */
 		void setObject(Object* object_);
@@ -73,6 +83,16 @@ class RayPayload {
 		/*! Set the distance the ray travelled before intersecting
 		 * \param distance_ Distance the tray travelled before intersecting */
 		void setDistance(float distance_);
+		
+		
+		/*! Set the barycentric coordinates of the intersection
+		 * \param baryCoords_ The barycentric coordinates of the point where the ray hit a triangle */
+		void setBarycentricCoords(Vec3f baryCoords_);
+		
+		
+		/*! Set the index of the face which was hit
+		 * \param primitive_ Index of the face within the object */
+		void setPrimitive(int primitive_);
 	
 	private:
 	
@@ -90,6 +110,12 @@ class RayPayload {
 		
 		/*! The distance the ray travelled from the origin */
 		float distance;
+		
+		/*! Barycentric coordinates of the intersection, computed once by the intersection test */
+		Vec3f baryCoords;
+		
+		/*! Index of the face hit within an object made of many faces */
+		int primitive;
 	
 };
 
@@ -0,0 +1,224 @@
+#include "RenderOptions.hpp"
+#include <iostream>
+#include <cstdlib>
+#include "PixelTraversal.hpp"
+#include "CostHeatmap.hpp"
+
+RenderOptions::RenderOptions(){
+	lightCutoff = 1.f / 256.f;
+	lightSamples = 0;
+	smoothNormals = false;
+	wavefront = false;
+	batchSize = 4096;
+	tileCacheFile = "";
+	pixelFormat = "float";
+	outOfCore = false;
+	textureCacheMb = 64;
+	textureTileDir = "texture-tiles";
+	traversal = "scanline";
+	tileSize = 16;
+	threads = 1;
+	compactMeshes = false;
+	weldEpsilon = 0.f;
+	maxDepth = 5;
+	minContribution = 1.f / 256.f;
+	rouletteDepth = 3;
+	rayBudget = 64;
+	heatmap = "";
+}
+
+RenderOptions RenderOptions::parse(int argc, char** argv){
+	
+	RenderOptions options;
+	
+	// The first argument is the scene file, every later argument is a flag
+	for(int i = 2; i < argc; i++){
+		
+		std::string flag( argv[i] );
+		bool hasValue = ( i+1 < argc );
+		
+		if( flag == "--light-cutoff" && hasValue ){
+			options.lightCutoff = atof( argv[++i] );
+			if( options.lightCutoff < 0.f ){
+				std::cout << "Error: --light-cutoff must be a nonnegative float.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--light-samples" && hasValue ){
+			options.lightSamples = atoi( argv[++i] );
+			if( options.lightSamples < 0 ){
+				std::cout << "Error: --light-samples must be a nonnegative integer.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--smooth-normals" ){
+			options.smoothNormals = true;
+		}
+		
+		else if( flag == "--wavefront" ){
+			options.wavefront = true;
+		}
+		
+		else if( flag == "--batch-size" && hasValue ){
+			options.batchSize = atoi( argv[++i] );
+			if( options.batchSize <= 0 ){
+				std::cout << "Error: --batch-size must be a positive integer.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--tile-cache" && hasValue ){
+			options.tileCacheFile = argv[++i];
+		}
+		
+		else if( flag == "--pixel-format" && hasValue ){
+			options.pixelFormat = argv[++i];
+			if( options.pixelFormat != "float" && options.pixelFormat != "half" && options.pixelFormat != "rgb8" ){
+				std::cout << "Error: --pixel-format must be one of float, half, or rgb8.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--out-of-core" ){
+			options.outOfCore = true;
+		}
+		
+		else if( flag == "--texture-cache-mb" && hasValue ){
+			options.textureCacheMb = atoi( argv[++i] );
+			if( options.textureCacheMb <= 0 ){
+				std::cout << "Error: --texture-cache-mb must be a positive integer.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--texture-tile-dir" && hasValue ){
+			options.textureTileDir = argv[++i];
+		}
+		
+		else if( flag == "--traversal" && hasValue ){
+			options.traversal = argv[++i];
+			if( !PixelTraversal::isValidOrder( options.traversal ) ){
+				std::cout << "Error: --traversal must be one of scanline, tiles, hilbert, or morton.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--tile-size" && hasValue ){
+			options.tileSize = atoi( argv[++i] );
+			if( options.tileSize <= 0 ){
+				std::cout << "Error: --tile-size must be a positive integer.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--threads" && hasValue ){
+			options.threads = atoi( argv[++i] );
+			if( options.threads < 0 ){
+				std::cout << "Error: --threads must be a nonnegative integer.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--compact-meshes" ){
+			options.compactMeshes = true;
+		}
+		
+		else if( flag == "--weld" && hasValue ){
+			options.weldEpsilon = atof( argv[++i] );
+			if( !( options.weldEpsilon > 0.f ) ){
+				std::cout << "Error: --weld must be a positive distance.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--max-depth" && hasValue ){
+			options.maxDepth = atoi( argv[++i] );
+			if( options.maxDepth < 0 ){
+				std::cout << "Error: --max-depth must be a nonnegative integer.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--min-contribution" && hasValue ){
+			options.minContribution = atof( argv[++i] );
+			if( options.minContribution < 0.f ){
+				std::cout << "Error: --min-contribution must be a nonnegative float.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--roulette-depth" && hasValue ){
+			options.rouletteDepth = atoi( argv[++i] );
+			if( options.rouletteDepth < 0 ){
+				std::cout << "Error: --roulette-depth must be a nonnegative integer.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--ray-budget" && hasValue ){
+			options.rayBudget = atoi( argv[++i] );
+			if( options.rayBudget < 0 ){
+				std::cout << "Error: --ray-budget must be a nonnegative integer.\n";
+				exit(0);
+			}
+		}
+		
+		else if( flag == "--heatmap" && hasValue ){
+			options.heatmap = argv[++i];
+			if( !CostHeatmap::isValidMetric( options.heatmap ) ){
+				std::cout << "Error: --heatmap must be one of tests, steps, or time.\n";
+				exit(0);
+			}
+		}
+		
+		else {
+			std::cout << "Error: Invalid command line flag \"" << flag << "\"\n";
+			printUsage();
+			exit(0);
+		}
+		
+	}
+	
+	// The heatmap needs the cost of each pixel on its own, which the batched and cached paths do not give
+	if( options.heatmap != "" && ( options.wavefront || options.tileCacheFile != "" ) ){
+		std::cout << "Error: --heatmap cannot be combined with --wavefront or --tile-cache.\n";
+		exit(0);
+	}
+	
+	// The tile cache renders tile by tile on one thread, so it would silently ignore the other renderers' options
+	if( options.tileCacheFile != "" && ( options.wavefront || options.threads != 1 || options.traversal != "scanline" ) ){
+		std::cout << "Error: --tile-cache cannot be combined with --wavefront, --threads, or --traversal.\n";
+		exit(0);
+	}
+	
+	return options;
+	
+}
+
+void RenderOptions::printUsage(){
+	
+	std::cout << "Usage: ./raytracer <scene file> [flags]\n"
+	          << "  --light-cutoff <float>   skip lights contributing less than this at a point (default 1/256)\n"
+	          << "  --light-samples <int>    sample this many lights per shading point, 0 for all (default 0)\n"
+	          << "  --smooth-normals         generate vertex normals for triangles given without vn data\n"
+	          << "  --wavefront              render in batches, sorting rays for coherence between stages\n"
+	          << "  --batch-size <int>       pixels per wavefront batch (default 4096)\n"
+	          << "  --tile-cache <file>      re-render only the tiles affected by edits since the render cached in file\n"
+	          << "  --pixel-format <format>  store pixels as float, half, or rgb8 until the image is saved (default float)\n"
+	          << "  --out-of-core            write pixels straight to a binary PPM file instead of keeping the image in memory\n"
+	          << "  --texture-cache-mb <int> most memory kept for texture tiles, in megabytes (default 64)\n"
+	          << "  --texture-tile-dir <dir> directory for textures converted to tiles (default texture-tiles)\n"
+	          << "  --traversal <order>      trace pixels in scanline, tiles, hilbert, or morton order (default scanline)\n"
+	          << "  --tile-size <int>        tile edge length in pixels for every traversal but scanline (default 16)\n"
+	          << "  --threads <int>          threads tracing pixels, 0 for one per hardware thread (default 1)\n"
+	          << "  --compact-meshes         store triangles as quantized meshes to save memory on very large scenes\n"
+	          << "  --weld <float>           merge vertices closer than this distance with the same normal and texture coordinates\n"
+	          << "  --max-depth <int>        reflection and refraction bounces per pixel, 0 for none (default 5)\n"
+	          << "  --min-contribution <float> skip bounces changing a pixel by less than this (default 1/256)\n"
+	          << "  --roulette-depth <int>   end bounces past this depth at random by Russian roulette (default 3)\n"
+	          << "  --ray-budget <int>       most reflected and refracted rays per pixel (default 64)\n"
+	          << "  --heatmap <metric>       also save a heatmap of intersection tests, traversal steps, or time per pixel\n";
+	
+}
@@ -0,0 +1,93 @@
+/**
+ * \author George Brown
+ *
+ * \file RenderOptions.hpp 
+ * \brief Settings which control how a scene is rendered, as opposed to what is in it.
+ *        They are given as optional flags on the command line after the scene file.
+ */
+
+#ifndef RENDER_OPTIONS_HPP
+#define RENDER_OPTIONS_HPP
+
+#include <string>
+
+/*! \class RenderOptions Class which stores the rendering settings parsed from the command line */
+class RenderOptions {
+	
+	public:
+	
+		/*! RenderOptions constructor. Initializes every setting to its default */
+		RenderOptions();
+		
+		/*! Parses the optional flags which follow the scene file on the command line
+		 * \param argc The number of arguments
+		 * \param argv The arguments
+		 * \return The parsed options */
+		static RenderOptions parse(int argc, char** argv);
+		
+		/*! Prints the usage of every flag */
+		static void printUsage();
+		
+		/*! Lights whose contribution at a point falls below this value are culled there */
+		float lightCutoff;
+		
+		/*! Number of lights sampled stochastically per shading point, or 0 to evaluate every light */
+		int lightSamples;
+		
+		/*! Generates averaged vertex normals for triangles which were given without vn data */
+		bool smoothNormals;
+		
+		/*! Renders in batches with the wavefront pipeline instead of one pixel at a time */
+		bool wavefront;
+		
+		/*! Number of pixels in each wavefront batch */
+		int batchSize;
+		
+		/*! File holding the tiles of the previous render, or empty to render every pixel from scratch */
+		std::string tileCacheFile;
+		
+		/*! How pixels are stored until the image is saved: "float", "half", or "rgb8" */
+		std::string pixelFormat;
+		
+		/*! Writes pixels straight to a binary PPM file as they are finished instead of keeping them in memory */
+		bool outOfCore;
+		
+		/*! Most memory the texture tile cache may take up, in megabytes */
+		int textureCacheMb;
+		
+		/*! Directory holding the tiled files converted from PPM textures */
+		std::string textureTileDir;
+		
+		/*! Order in which pixels are traced: "scanline", "tiles", "hilbert", or "morton" */
+		std::string traversal;
+		
+		/*! Edge length in pixels of the tiles visited by every traversal order except scanline */
+		int tileSize;
+		
+		/*! Number of threads tracing pixels, or 0 for one per hardware thread */
+		int threads;
+		
+		/*! Stores triangles as quantized compact meshes instead of one object per face */
+		bool compactMeshes;
+		
+		/*! Vertices closer than this with the same attributes are merged when the scene is loaded, or 0 for no welding */
+		float weldEpsilon;
+		
+		/*! Most reflection and refraction bounces followed from a primary hit, or 0 for direct lighting only */
+		int maxDepth;
+		
+		/*! Reflected and refracted rays which could change the pixel by less than this are not traced */
+		float minContribution;
+		
+		/*! Bounces past this depth are ended at random by Russian roulette */
+		int rouletteDepth;
+		
+		/*! Most reflected and refracted rays traced for one pixel */
+		int rayBudget;
+		
+		/*! Cost recorded for each pixel in a heatmap: "tests", "steps", "time", or empty for no heatmap */
+		std::string heatmap;
+		
+};
+
+#endif
@@ -1,5 +1,19 @@
 #include "Scene.hpp"
 #include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include <map>
+#include "CompactMesh.hpp"
+#include "CostCounter.hpp"
+
+SecondaryRayCounts::SecondaryRayCounts()
+	: traced(0), culled(0), rouletted(0), overBudget(0) {
+}
+
+SecondaryRayCounts::SecondaryRayCounts(const SecondaryRayCounts& other)
+	: traced( other.traced.load() ), culled( other.culled.load() ), rouletted( other.rouletted.load() ), overBudget( other.overBudget.load() ) {
+}
+
 
 Scene::Scene(){
 	
@@ -10,6 +24,12 @@ Scene::Scene(){
 	envDimsSet = false;
 	bkgColorSet = false;
 	
+	viewSignature = 0;
+	geometrySignature = 0;
+	
+	textureCache = 0;
+	numPackedSpheres = 0;
+	
 }
 
 // Getters //
@@ -45,6 +65,22 @@ std::vector<Object*> Scene::getObjects() const{
 std::string Scene::getSceneName() const{
 	return sceneName;
 }
+
+uint64_t Scene::getViewSignature() const{
+	return viewSignature;
+}
+
+uint64_t Scene::getGeometrySignature() const{
+	return geometrySignature;
+}
+
+const RenderOptions& Scene::getRenderOptions() const{
+	return options;
+}
+
+TextureCache* Scene::getTextureCache() const{
+	return textureCache;
+}
 		
 // Setters //
 void Scene::setEyePos(Vec3f eyePos_){
@@ -81,6 +117,22 @@ void Scene::setSceneName(std::string sceneName_){
 	sceneName = sceneName_;
 }
 
+void Scene::setViewSignature(uint64_t viewSignature_){
+	viewSignature = viewSignature_;
+}
+
+void Scene::setGeometrySignature(uint64_t geometrySignature_){
+	geometrySignature = geometrySignature_;
+}
+
+void Scene::setRenderOptions(const RenderOptions& options_){
+	options = options_;
+}
+
+void Scene::setTextureCache(TextureCache* textureCache_){
+	textureCache = textureCache_;
+}
+
 
 // Data printing for debugging purposes //
 void Scene::printData() const{
@@ -93,34 +145,41 @@ void Scene::printData() const{
 	std::cout << "Env dims: " <<  envDims.to_str() << std::endl;
 	std::cout << "Bkg color: " << bkgColor.to_str() << std::endl;
 	
-	//std::cout << "num point lights .. " << pointLights.size() << std::endl;
-	//std::cout << "num dir lights .. " << directionalLights.size() << std::endl;
-	
-	
-	// computing vertex normals here...
-	/*std::cout << "computing vertex normals .. \n";
-	for(int i = 0; i < verts.size(); i++){
-	
-		Vec3f vecSum(0.f,0.f,0.f);
+}
+
+
+// Prints how often the cached occluder of each light answered a shadow query on its own //
+void Scene::printShadowCacheStats() const{
 	
-		for(int j = 0; j < objects.size(); j++){
-		
-			Triangle* tri = dynamic_cast<Triangle*>( objects[j] );
-			
-			if( tri->verts[0] == verts[i] || tri->verts[1] == verts[i] || tri->verts[2] == verts[i] ){
-				vecSum = vecSum + tri->normal;
-			}
-		
-		}
-		
-		Vec3f avgNormal = Vec3f::normalize( vecSum );
+	std::cout << "Shadow occluder cache: \n";
+	for(int i = 0; i < lights.size(); i++){
 		
-		std::cout << avgNormal.to_str() << std::endl;
+		long lookups = lights[i]->getShadowCacheLookups();
+		long hits = lights[i]->getShadowCacheHits();
+		float hitRate = lookups > 0 ? 100.f * hits / float(lookups) : 0.f;
 		
-	} */
+		std::cout << "Light " << i << ": " << hits << " hits / " << lookups << " lookups (" << hitRate << "%)" << std::endl;
+	}
 	
+}
+
+
+// Prints how often a texture lookup found its tile already in memory //
+void Scene::printTextureCacheStats() const{
 	
+	if( textureCache != 0 ){
+		textureCache->printStats();
+	}
 	
+}
+
+void Scene::printSecondaryRayStats() const{
+	
+	const SecondaryRayCounts& c = secondaryCounts;
+	if( c.traced + c.culled + c.rouletted + c.overBudget > 0 ){
+		std::cout << "Secondary rays: " << c.traced << " traced, " << c.culled << " culled by contribution, "
+		          << c.rouletted << " ended by roulette, " << c.overBudget << " over budget\n";
+	}
 	
 }
 
@@ -155,6 +214,244 @@ void Scene::verifySetup(){
 }
 
 
+// Builds the acceleration structures once the scene is complete
+void Scene::prepare(){
+	
+	if( options.weldEpsilon > 0.f ){
+		weldVertices( options.weldEpsilon );
+	}
+	
+	if( options.smoothNormals ){
+		generateVertexNormals();
+	}
+	
+	if( options.compactMeshes ){
+		compactTriangles();
+	}
+	
+	// Spheres are packed so that each ray is tested against eight of them at a time
+	spherePackets.clear();
+	otherObjects.clear();
+	numPackedSpheres = 0;
+	for(int i = 0; i < objects.size(); i++){
+		Sphere* sphere = dynamic_cast<Sphere*>( objects[i] );
+		if( sphere == 0 ){
+			otherObjects.push_back( objects[i] );
+		} else {
+			if( spherePackets.empty() || spherePackets.back().size() == SpherePacket::WIDTH ){
+				spherePackets.push_back( SpherePacket() );
+			}
+			spherePackets.back().add( sphere );
+			numPackedSpheres++;
+		}
+	}
+	
+	lightGrid.build( lights, options.lightCutoff );
+	
+	if( lightGrid.getNumBoundedLights() > 0 ){
+		std::cout << "Light grid: " << lightGrid.getNumBoundedLights() << " of " << lights.size()
+		          << " lights in " << lightGrid.getDims().to_str() << " cells\n";
+	}
+	
+}
+
+
+// Averages the normals of the triangles around each vertex
+void Scene::generateVertexNormals(){
+	
+	std::vector<Triangle*> flatTris;
+	std::unordered_map<Vert*,Vec3f> normalSums;
+	
+	for(int i = 0; i < objects.size(); i++){
+		
+		Triangle* tri = dynamic_cast<Triangle*>( objects[i] );
+		if( tri == 0 || tri->getNormalsProvided() ){
+			continue;
+		}
+		
+		flatTris.push_back( tri );
+		Vec3f n = tri->getAreaWeightedNormal();
+		for(int k = 0; k < 3; k++){
+			if( !tri->getVert(k)->hasNormal() ){
+				normalSums[ tri->getVert(k) ] = normalSums[ tri->getVert(k) ] + n;
+			}
+		}
+	}
+	
+	// Normals which sum to zero, around degenerate faces or faces which cancel out, are left unset
+	int numNormals = 0;
+	for(std::unordered_map<Vert*,Vec3f>::iterator it = normalSums.begin(); it != normalSums.end(); ++it){
+		if( Vec3f::norm( (*it).second ) > 0.f ){
+			(*it).first->setNormal( Vec3f::normalize( (*it).second ) );
+			numNormals++;
+		}
+	}
+	
+	// A triangle is only smooth shaded if all three of its vertices got a normal, and stays flat otherwise
+	int numSmooth = 0;
+	for(int i = 0; i < flatTris.size(); i++){
+		if( flatTris[i]->getVert(0)->hasNormal() && flatTris[i]->getVert(1)->hasNormal() && flatTris[i]->getVert(2)->hasNormal() ){
+			flatTris[i]->setNormalsProvided(true);
+			numSmooth++;
+		}
+	}
+	
+	std::cout << "Generated " << numNormals << " vertex normals for " << numSmooth << " triangles\n";
+	
+}
+
+
+// Merges nearby vertices with matching attributes and remaps the triangles onto them
+void Scene::weldVertices(float epsilon){
+	
+	// Any vertex within epsilon of another lies in the same cell or one of its 26 neighbours
+	std::unordered_map< long long, std::vector<Vert*> > cells;
+	std::unordered_map<Vert*,Vert*> merged;
+	std::vector<Vert*> kept;
+	
+	for(int v = 0; v < verts.size(); v++){
+		
+		Vec3f pos = verts[v]->getPos();
+		long long cx = (long long)floor( pos.x / epsilon );
+		long long cy = (long long)floor( pos.y / epsilon );
+		long long cz = (long long)floor( pos.z / epsilon );
+		
+		Vert* target = 0;
+		for(int dx = -1; dx <= 1 && target == 0; dx++){
+			for(int dy = -1; dy <= 1 && target == 0; dy++){
+				for(int dz = -1; dz <= 1 && target == 0; dz++){
+					std::unordered_map< long long, std::vector<Vert*> >::iterator cell = cells.find( weldCellKey( cx+dx, cy+dy, cz+dz ) );
+					if( cell == cells.end() ){
+						continue;
+					}
+					
+					// Different cells may share a key, which the distance test sorts out
+					for(int c = 0; c < (*cell).second.size(); c++){
+						Vert* other = (*cell).second[c];
+						if( Vec3f::norm( other->getPos() - pos ) <= epsilon && other->hasSameAttributes( *verts[v] ) ){
+							target = other;
+							break;
+						}
+					}
+				}
+			}
+		}
+		
+		if( target == 0 ){
+			cells[ weldCellKey( cx, cy, cz ) ].push_back( verts[v] );
+			kept.push_back( verts[v] );
+		} else {
+			merged[ verts[v] ] = target;
+		}
+		
+	}
+	
+	if( merged.empty() ){
+		std::cout << "Welded no vertices: none of the " << verts.size() << " vertices are within " << epsilon << " of a matching one\n";
+		return;
+	}
+	
+	std::vector<Object*> remaining;
+	int numDegenerate = 0;
+	for(int i = 0; i < objects.size(); i++){
+		
+		Triangle* tri = dynamic_cast<Triangle*>( objects[i] );
+		if( tri == 0 ){
+			remaining.push_back( objects[i] );
+			continue;
+		}
+		
+		Vert* triVerts[3];
+		bool changed = false;
+		for(int k = 0; k < 3; k++){
+			std::unordered_map<Vert*,Vert*>::iterator it = merged.find( tri->getVert(k) );
+			triVerts[k] = ( it == merged.end() ) ? tri->getVert(k) : (*it).second;
+			changed = changed || it != merged.end();
+		}
+		
+		if( triVerts[0] == triVerts[1] || triVerts[1] == triVerts[2] || triVerts[0] == triVerts[2] ){
+			numDegenerate++;
+			delete tri;
+			continue;
+		}
+		if( changed ){
+			tri->setVerts( triVerts[0], triVerts[1], triVerts[2] );
+		}
+		remaining.push_back( tri );
+		
+	}
+	
+	for(std::unordered_map<Vert*,Vert*>::iterator it = merged.begin(); it != merged.end(); ++it){
+		delete (*it).first;
+	}
+	
+	long bytesSaved = long(merged.size()) * ( sizeof(Vert) + sizeof(Vert*) ) + long(numDegenerate) * ( sizeof(Triangle) + sizeof(Object*) );
+	std::cout << "Welded " << verts.size() << " vertices into " << kept.size() << ": removed " << merged.size()
+	          << " vertices and " << numDegenerate << " degenerate triangles, saving " << bytesSaved << " bytes\n";
+	
+	verts = kept;
+	objects = remaining;
+	
+}
+
+// Hashes the integer coordinates of a welding grid cell
+long long Scene::weldCellKey(long long x, long long y, long long z){
+	return ( x * 73856093LL ) ^ ( y * 19349663LL ) ^ ( z * 83492791LL );
+}
+
+
+// Groups the triangles by shading parameters and stores each group as one compact mesh
+void Scene::compactTriangles(){
+	
+	typedef std::pair< std::pair<Material*,Texture*>, bool > MeshKey;
+	std::map< MeshKey, std::vector<Triangle*> > groups;
+	std::vector<Object*> remaining;
+	
+	for(int i = 0; i < objects.size(); i++){
+		Triangle* tri = dynamic_cast<Triangle*>( objects[i] );
+		if( tri == 0 ){
+			remaining.push_back( objects[i] );
+		} else {
+			groups[ MeshKey( std::make_pair( tri->getMaterial(), tri->getTexture() ), tri->getNormalsProvided() ) ].push_back( tri );
+		}
+	}
+	if( groups.empty() ){
+		return;
+	}
+	
+	int numTriangles = 0;
+	long meshBytes = 0;
+	for(std::map< MeshKey, std::vector<Triangle*> >::iterator it = groups.begin(); it != groups.end(); ++it){
+		
+		const std::vector<Triangle*>& tris = (*it).second;
+		CompactMesh* mesh = new CompactMesh( tris );
+		
+		// Every triangle of the group was given the same material and texture, so has the same signature
+		mesh->setSignature( tris[0]->getSignature() );
+		remaining.push_back( mesh );
+		
+		numTriangles += tris.size();
+		meshBytes += mesh->getMemoryBytes();
+		for(int t = 0; t < tris.size(); t++){
+			delete tris[t];
+		}
+		
+	}
+	
+	long triangleBytes = long(numTriangles) * ( sizeof(Triangle) + sizeof(Object*) ) + long(verts.size()) * ( sizeof(Vert) + sizeof(Vert*) );
+	for(int v = 0; v < verts.size(); v++){
+		delete verts[v];
+	}
+	verts.clear();
+	objects = remaining;
+	
+	std::cout << "Compacted " << numTriangles << " triangles into " << groups.size() << " meshes: "
+	          << meshBytes << " bytes (" << float(meshBytes) / numTriangles << " per triangle), down from "
+	          << triangleBytes << " bytes (" << float(triangleBytes) / numTriangles << " per triangle)\n";
+	
+}
+
+
 // Adds a point light to the scene
 void Scene::addPointLight(PointLight* pointLight){
 	lights.push_back( pointLight );
@@ -193,7 +490,7 @@ void Scene::addNormal(Vec3f normal_){
 	normals.push_back( Vec3f::normalize(normal_) );
 }
 
-void Scene::addTriangle(Vec3i v1_, Vec3i& v2_, Vec3i& v3_, Material* material_, Texture* texture_ ){
+Triangle* Scene::addTriangle(Vec3i v1_, Vec3i& v2_, Vec3i& v3_, Material* material_, Texture* texture_ ){
 	
 	if( v1_.x > 0 && v1_.x <= verts.size() &&
 	    v2_.x > 0 && v2_.x <= verts.size() && 
@@ -240,7 +537,7 @@ void Scene::addTriangle(Vec3i v1_, Vec3i& v2_, Vec3i& v3_, Material* material_,
 		}
 		
 		objects.push_back( tri );
-		
+		return tri;
 		
 	} else {
 		
@@ -254,83 +551,318 @@ void Scene::addTriangle(Vec3i v1_, Vec3i& v2_, Vec3i& v3_, Material* material_,
 
 void Scene::traceRay(Ray& ray, RayPayload& rayPayload){
 	
-	for(int i = 0; i < objects.size(); i++){	
-		if( objects[i]->intersect( ray , rayPayload ) ){
-			rayPayload.setObject(objects[i]);
+	CostCounter::addSteps( spherePackets.size() );
+	CostCounter::addTests( numPackedSpheres + otherObjects.size() );
+	
+	for(int i = 0; i < spherePackets.size(); i++){
+		float t = 0.f;
+		int lane = spherePackets[i].intersect( ray, 0.f, rayPayload.getDistance(), t );
+		if( lane >= 0 ){
+			Sphere* sphere = spherePackets[i].getSphere(lane);
+			sphere->setHit( ray, t, rayPayload );
+			rayPayload.setObject(sphere);
+		}
+	}
+	
+	for(int i = 0; i < otherObjects.size(); i++){	
+		if( otherObjects[i]->intersect( ray , rayPayload ) ){
+			rayPayload.setObject(otherObjects[i]);
 		}
 	}
 	
 }
 
-Vec3f Scene::shadeRay(Ray& ray, RayPayload& rayPayload){
+void Scene::traceBatch(std::vector<Ray>& rays, std::vector<RayPayload>& rayPayloads){
 	
-	// Extracting material data	
-	Material* mat = rayPayload.getMaterial();
+	for(int i = 0; i < spherePackets.size(); i++){
+		const SpherePacket& packet = spherePackets[i];
+		for(int r = 0; r < rays.size(); r++){
+			float t = 0.f;
+			int lane = packet.intersect( rays[r], 0.f, rayPayloads[r].getDistance(), t );
+			if( lane >= 0 ){
+				packet.getSphere(lane)->setHit( rays[r], t, rayPayloads[r] );
+				rayPayloads[r].setObject( packet.getSphere(lane) );
+			}
+		}
+	}
 	
-	// Extracting the object data
-	Object* obj = rayPayload.getObject();
+	for(int i = 0; i < otherObjects.size(); i++){
+		Object* obj = otherObjects[i];
+		for(int r = 0; r < rays.size(); r++){
+			if( obj->intersect( rays[r] , rayPayloads[r] ) ){
+				rayPayloads[r].setObject(obj);
+			}
+		}
+	}
 	
-	// Point of intersection with the object
-	Vec3f intersectPoint = ray.getOrigin() + rayPayload.getDistance() * ray.getDir();
+}
+
+void Scene::selectLights(Vec3f point, Random& rng, std::vector<LightSample>& samples){
 	
-	// Vector parameters for computing Phong illumination
-	Vec3f N = obj -> getUnitSurfaceNormal( intersectPoint );
-	Vec3f V = Vec3f::normalize( eyePos - intersectPoint );
+	static thread_local std::vector<int> candidates;
+	static thread_local std::vector<float> cumulative;
 	
-	Vec3f diffuseColor;
-	if( rayPayload.getTexture() != 0 && rayPayload.getTexture() != NULL ){
-		diffuseColor = rayPayload.getTextureColor();
-	} else {
-		diffuseColor = mat->getOd();
+	samples.clear();
+	candidates.clear();
+	lightGrid.query( point, candidates );
+	
+	// Without sampling, or with fewer candidates than samples, every contributing light is used
+	const int numSamples = options.lightSamples;
+	if( numSamples == 0 || candidates.size() <= numSamples ){
+		for(int i = 0; i < candidates.size(); i++){
+			LightSample sample = { candidates[i], 1.f };
+			samples.push_back( sample );
+		}
+		return;
 	}
 	
-	// The color data, initialized to the ambient color in the absence of lights.
-	Vec3f Ilam = mat->getKa() * diffuseColor;
+	// Otherwise lights are drawn with probability proportional to their unshadowed intensity at the point
+	cumulative.resize( candidates.size() );
+	float total = 0.f;
+	for(int i = 0; i < candidates.size(); i++){
+		Vec3f rgb = lights[candidates[i]]->getRGB();
+		total += std::max( rgb.x, std::max(rgb.y,rgb.z) ) * lights[candidates[i]]->computeAttenuation(point);
+		cumulative[i] = total;
+	}
 	
-	// Looping through all lights in the scene and adding the diffuse and specular components
-	for(int i = 0; i < lights.size(); i++){
-			
-		// Phong illumination vectors
-		Vec3f L = lights[i] -> computeL(intersectPoint);
-		Vec3f H = Vec3f::normalize( L + V );
-			
-		// Boolean which is set to true if the light in question is blocked by another object
-		bool blocked = lights[i] -> isBlocked( objects, obj, intersectPoint );	
+	if( total <= 0.f ){
+		return;
+	}
+	
+	for(int s = 0; s < numSamples; s++){
 		
-		// If the object is not blocked, we add the specular and diffuse contributions of the light
-		if( !blocked ){
-				
-			Vec3f diffuseTerm = mat->getKd() * diffuseColor * std::max( ( Vec3f::dot(N,L) ) , 0.f );
-			Vec3f specularTerm = mat->getKs() * mat->getOs() * powf( std::max( ( Vec3f::dot(N,H) ) , 0.f), mat->getN() );
-			Vec3f rgb = lights[i]->getRGB();
-				
-			float lightIntensityR = rgb.x * (diffuseTerm.x + specularTerm.x);
-			float lightIntensityG = rgb.y * (diffuseTerm.y + specularTerm.y);
-			float lightIntensityB = rgb.z * (diffuseTerm.z + specularTerm.z);
-
-			Ilam = Ilam + Vec3f( lightIntensityR , lightIntensityG, lightIntensityB );
-
-		}
-			
+		float u = rng.nextFloat() * total;
+		int i = std::upper_bound( cumulative.begin(), cumulative.end(), u ) - cumulative.begin();
+		i = std::min( i, int(candidates.size())-1 );
+		
+		float p = ( cumulative[i] - (i > 0 ? cumulative[i-1] : 0.f) ) / total;
+		LightSample sample = { candidates[i], 1.f / (numSamples * p) };
+		samples.push_back( sample );
 	}
 	
-	// The RGB values are clamped to the range 0-1 to avoid overflow
-	return Vec3f::clamp(Ilam,0,1);
+}
 
+Vec3f Scene::shadeRay(Ray& ray, RayPayload& rayPayload, Random& rng, std::vector<SurfaceHit>* secondaryHits){
+	
+	int rayBudget = options.rayBudget;
+	return shadeRay( ray, rayPayload, rng, 0, 1.f, rayBudget, secondaryHits );
 	
 }
 
+Vec3f Scene::shadeSecondary(Ray& ray, const SurfaceHit& hit, Random& rng, std::vector<SurfaceHit>* secondaryHits){
+	
+	int rayBudget = options.rayBudget;
+	return secondaryTerm( ray, hit, rng, 0, 1.f, rayBudget, secondaryHits );
+	
+}
 
+Vec3f Scene::shadeRay(Ray& ray, RayPayload& rayPayload, Random& rng, int depth, float throughput,
+                      int& rayBudget, std::vector<SurfaceHit>* secondaryHits){
+	
+	SurfaceHit hit = computeSurfaceHit( ray, rayPayload );
+	if( depth > 0 && secondaryHits != 0 ){
+		secondaryHits->push_back( hit );
+	}
+	
+	// The RGB values are clamped to the range 0-1 to avoid overflow, before and after adding
+	// the light carried back by reflected and refracted rays
+	Vec3f color = Vec3f::clamp( directTerm( hit, rng ), 0, 1 );
+	return Vec3f::clamp( color + secondaryTerm( ray, hit, rng, depth, throughput, rayBudget, secondaryHits ), 0, 1 );
+	
+}
 
+Vec3f Scene::directTerm(const SurfaceHit& hit, Random& rng){
+	
+	static thread_local std::vector<LightSample> samples;
+	
+	// The color data, initialized to the ambient color in the absence of lights.
+	Vec3f Ilam = ambientTerm( hit );
+	
+	// Looping through the lights chosen for this point and adding the diffuse and specular components
+	// of each light which is not blocked by another object
+	selectLights( hit.point, rng, samples );
+	for(int s = 0; s < samples.size(); s++){
+		
+		Ray shadowRay = lights[ samples[s].light ] -> computeShadowRay( hit.point );
+		
+		if( !isLightBlocked( hit, samples[s].light, shadowRay ) ){
+			Ilam = Ilam + lightTerm( hit, samples[s] );
+		}
+			
+	}
+	
+	return Ilam;
+	
+}
 
+Vec3f Scene::secondaryTerm(Ray& ray, const SurfaceHit& hit, Random& rng, int depth, float throughput,
+                           int& rayBudget, std::vector<SurfaceHit>* secondaryHits){
+	
+	Material* mat = hit.mat;
+	if( depth >= options.maxDepth || ( mat->getAlpha() == 1.f && mat->getEta() == 1.f ) ){
+		return Vec3f(0.f,0.f,0.f);
+	}
+	
+	// The normal is turned to face the incoming ray. Rays only travel inside transparent objects,
+	// so the back of an opaque surface reflects as if seen from outside
+	Vec3f I = ray.getDir();
+	Vec3f N = hit.N;
+	float cosI = -Vec3f::dot( I, N );
+	bool entering = ( cosI >= 0.f || mat->getAlpha() == 1.f );
+	if( cosI < 0.f ){
+		N = -1.f * N;
+		cosI = -cosI;
+	}
+	float etaI = entering ? 1.f : mat->getEta();
+	float etaT = entering ? mat->getEta() : 1.f;
+	
+	// Schlick's approximation of the Fresnel reflectance. With an index of 1 there is no interface to reflect from
+	float Fr = 0.f;
+	if( mat->getEta() != 1.f ){
+		float F0 = powf( (etaT - etaI) / (etaT + etaI), 2.f );
+		Fr = F0 + (1.f - F0) * powf( 1.f - cosI, 5.f );
+	}
+	
+	float reflectWeight = Fr;
+	float transmitWeight = (1.f - Fr) * (1.f - mat->getAlpha());
+	
+	float ratio = etaI / etaT;
+	float sin2T = ratio * ratio * (1.f - cosI * cosI);
+	if( sin2T > 1.f ){
+		// Total internal reflection: the light which would have been transmitted is reflected instead
+		reflectWeight += transmitWeight;
+		transmitWeight = 0.f;
+	}
+	
+	// The rays start slightly off the surface so that they do not hit it again straight away
+	const float offset = 0.005f;
+	Vec3f point = hit.point;
+	Ray reflected( point + offset * N, Vec3f::normalize( I + (2.f * cosI) * N ) );
+	Ray transmitted( point - offset * N, I );
+	if( transmitWeight > 0.f ){
+		transmitted = Ray( point - offset * N, Vec3f::normalize( ratio * I + ( ratio * cosI - sqrtf( 1.f - sin2T ) ) * N ) );
+	}
+	
+	// The heavier branch goes first, so that it gets the ray budget if there is not enough for both
+	Vec3f color(0.f,0.f,0.f);
+	if( reflectWeight >= transmitWeight ){
+		color = color + traceBranch( reflected, reflectWeight, rng, depth, throughput, rayBudget, secondaryHits );
+		color = color + traceBranch( transmitted, transmitWeight, rng, depth, throughput, rayBudget, secondaryHits );
+	} else {
+		color = color + traceBranch( transmitted, transmitWeight, rng, depth, throughput, rayBudget, secondaryHits );
+		color = color + traceBranch( reflected, reflectWeight, rng, depth, throughput, rayBudget, secondaryHits );
+	}
+	return color;
+	
+}
 
+Vec3f Scene::traceBranch(Ray& ray, float weight, Random& rng, int depth, float throughput,
+                         int& rayBudget, std::vector<SurfaceHit>* secondaryHits){
+	
+	if( weight <= 0.f ){
+		return Vec3f(0.f,0.f,0.f);
+	}
+	
+	// Colors are clamped to 0-1, so a ray can change the pixel by at most its share of the throughput
+	float contribution = throughput * weight;
+	if( contribution < options.minContribution ){
+		secondaryCounts.culled.fetch_add(1,std::memory_order_relaxed);
+		return Vec3f(0.f,0.f,0.f);
+	}
+	if( rayBudget <= 0 ){
+		secondaryCounts.overBudget.fetch_add(1,std::memory_order_relaxed);
+		return Vec3f(0.f,0.f,0.f);
+	}
+	
+	// Past the roulette depth a ray survives with probability equal to its contribution, and
+	// survivors are weighted up to keep the expected color unchanged
+	if( depth >= options.rouletteDepth ){
+		float survival = std::min( contribution, 1.f );
+		if( rng.nextFloat() >= survival ){
+			secondaryCounts.rouletted.fetch_add(1,std::memory_order_relaxed);
+			return Vec3f(0.f,0.f,0.f);
+		}
+		weight /= survival;
+		contribution /= survival;
+	}
+	
+	rayBudget--;
+	secondaryCounts.traced.fetch_add(1,std::memory_order_relaxed);
+	
+	RayPayload rayPayload;
+	traceRay( ray, rayPayload );
+	if( rayPayload.getMaterial() != 0 && rayPayload.getMaterial() != NULL ){
+		return weight * shadeRay( ray, rayPayload, rng, depth+1, contribution, rayBudget, secondaryHits );
+	} else {
+		return weight * bkgColor;
+	}
+	
+}
 
+SurfaceHit Scene::computeSurfaceHit(Ray& ray, RayPayload& rayPayload){
+	
+	SurfaceHit hit;
+	
+	// Extracting material and object data
+	hit.mat = rayPayload.getMaterial();
+	hit.obj = rayPayload.getObject();
+	
+	// Point of intersection with the object
+	hit.point = ray.getOrigin() + rayPayload.getDistance() * ray.getDir();
+	
+	// Vector parameters for computing Phong illumination
+	hit.N = hit.obj -> getUnitSurfaceNormal( hit.point, rayPayload );
+	hit.V = Vec3f::normalize( ray.getOrigin() - hit.point );
+	
+	if( rayPayload.getTexture() != 0 && rayPayload.getTexture() != NULL ){
+		hit.diffuseColor = rayPayload.getTextureColor();
+	} else {
+		hit.diffuseColor = hit.mat->getOd();
+	}
+	
+	return hit;
+	
+}
 
+Vec3f Scene::ambientTerm(const SurfaceHit& hit){
+	return hit.mat->getKa() * hit.diffuseColor;
+}
 
+Vec3f Scene::lightTerm(const SurfaceHit& hit, const LightSample& sample){
+	
+	Light* light = lights[ sample.light ];
+	Material* mat = hit.mat;
+	Vec3f N = hit.N;
+	
+	// Phong illumination vectors
+	Vec3f L = light -> computeL(hit.point);
+	Vec3f H = Vec3f::normalize( L + hit.V );
+	
+	Vec3f diffuseTerm = mat->getKd() * hit.diffuseColor * std::max( ( Vec3f::dot(N,L) ) , 0.f );
+	Vec3f specularTerm = mat->getKs() * mat->getOs() * powf( std::max( ( Vec3f::dot(N,H) ) , 0.f), mat->getN() );
+	Vec3f rgb = ( sample.weight * light->computeAttenuation(hit.point) ) * light->getRGB();
+		
+	float lightIntensityR = rgb.x * (diffuseTerm.x + specularTerm.x);
+	float lightIntensityG = rgb.y * (diffuseTerm.y + specularTerm.y);
+	float lightIntensityB = rgb.z * (diffuseTerm.z + specularTerm.z);
+	
+	return Vec3f( lightIntensityR , lightIntensityG, lightIntensityB );
+	
+}
 
+bool Scene::isLightBlocked(const SurfaceHit& hit, int lightIndex, Ray& shadowRay){
+	Light* light = lights[lightIndex];
+	return light -> isBlocked( otherObjects, spherePackets, hit.obj, shadowRay, light->computeShadowDistance( hit.point ) );
+}
 
+Light* Scene::getLight(int lightIndex) const{
+	return lights[lightIndex];
+}
 
+int Scene::getNumLights() const{
+	return lights.size();
+}
 
-
-
-
+void Scene::getCandidateLights(Vec3f point, std::vector<int>& lightIndices) const{
+	lightGrid.query( point, lightIndices );
+}
@@ -13,6 +13,8 @@
 #include <vector>
 #include <utility>
 #include <cstdlib>
+#include <cstdint>
+#include <atomic>
 #include "Object.hpp"
 #include "DirectionalLight.hpp"
 #include "PointLight.hpp"
@@ -20,6 +22,60 @@
 #include "Vert.hpp"
 #include "RayPayload.hpp"
 #include "Triangle.hpp"
+#include "LightGrid.hpp"
+#include "RenderOptions.hpp"
+#include "Random.hpp"
+#include "SpherePacket.hpp"
+#include "TextureCache.hpp"
+
+/*! \struct SurfaceHit Shading data for the point where a ray hit an object. It is gathered
+ *  once per hit and then reused for the contribution of every light. */
+struct SurfaceHit {
+	
+	/*! Point of intersection with the object */
+	Vec3f point;
+	
+	/*! Unit surface normal at the point */
+	Vec3f N;
+	
+	/*! Unit vector from the point towards the eye */
+	Vec3f V;
+	
+	/*! Diffuse color at the point, taken from the texture if there is one */
+	Vec3f diffuseColor;
+	
+	/*! Material of the object which was hit */
+	Material* mat;
+	
+	/*! The object which was hit */
+	Object* obj;
+	
+};
+
+/*! \struct SecondaryRayCounts Counts of reflected and refracted rays, updated by every render thread.
+ *  Copying a scene copies the counts as they are. */
+struct SecondaryRayCounts {
+	
+	/*! SecondaryRayCounts constructor, starting every count at zero */
+	SecondaryRayCounts();
+	
+	/*! SecondaryRayCounts copy constructor
+	 * \param other The counts to copy */
+	SecondaryRayCounts(const SecondaryRayCounts& other);
+	
+	/*! Rays which were traced */
+	std::atomic<long> traced;
+	
+	/*! Rays which could change the pixel by less than the contribution cutoff */
+	std::atomic<long> culled;
+	
+	/*! Rays ended by Russian roulette */
+	std::atomic<long> rouletted;
+	
+	/*! Rays dropped because the pixel's budget was spent */
+	std::atomic<long> overBudget;
+	
+};
 
 /*! \class Scene Class which stores all the scene data parsed from input
  * Data is stored using custom vector classes and physical objects
@@ -63,6 +119,30 @@ class Scene {
 		 * \return String identifier for the scene name */
 		std::string getSceneName() const;
 		
+		/*! Getter for the render options
+		 * \return The settings which control how the scene is rendered */
+		const RenderOptions& getRenderOptions() const;
+		
+		/*! Getter for the texture tile cache
+		 * \return The cache shared by every texture in the scene */
+		TextureCache* getTextureCache() const;
+		
+		/*! Getter for the view signature
+		 * \return Hash of the camera, image, and background settings in the scene file */
+		uint64_t getViewSignature() const;
+		
+		/*! Getter for the geometry signature
+		 * \return Hash of every vertex, face, and sphere in the scene file */
+		uint64_t getGeometrySignature() const;
+		
+		/*! Sets the view signature
+		 * \param viewSignature_ Hash of the camera, image, and background settings in the scene file */
+		void setViewSignature(uint64_t viewSignature_);
+		
+		/*! Sets the geometry signature
+		 * \param geometrySignature_ Hash of every vertex, face, and sphere in the scene file */
+		void setGeometrySignature(uint64_t geometrySignature_);
+		
 		/*! Sets the eye position
 		 * \param eyePos_ Eye position */
 		void setEyePos(Vec3f eyePos_);
@@ -91,9 +171,26 @@ class Scene {
 		 * \param sceneName The scene name as a string identifier */
 		void setSceneName(std::string sceneName);
 		
+		/*! Sets the render options
+		 * \param options_ The settings which control how the scene is rendered */
+		void setRenderOptions(const RenderOptions& options_);
+		
+		/*! Sets the texture tile cache
+		 * \param textureCache_ The cache shared by every texture in the scene */
+		void setTextureCache(TextureCache* textureCache_);
+		
 		/*! Prints data for debugger purposes */
 		void printData() const;
 		
+		/*! Prints the hit rate of each light's shadow-ray occluder cache */
+		void printShadowCacheStats() const;
+		
+		/*! Prints the hit rate of the texture tile cache */
+		void printTextureCacheStats() const;
+		
+		/*! Prints how many reflected and refracted rays were traced, and why the others were not */
+		void printSecondaryRayStats() const;
+		
 		/*! Adds an object to the scene
 		 * \param obj The object to add to the scene */
 		void addObject(Object* obj);
@@ -123,27 +220,166 @@ class Scene {
 		 * \param v2_ The second vertex of the triangle
 		 * \param v3_ The third vertex of the triangle
 		 * \param material_ The material of the triangle
-		 * \param texture_ The texture of the triangle */
-		void addTriangle(Vec3i v1_, Vec3i& v2_, Vec3i& v3_, Material* material_, Texture* texture_);
+		 * \param texture_ The texture of the triangle
+		 * \return The new triangle */
+		Triangle* addTriangle(Vec3i v1_, Vec3i& v2_, Vec3i& v3_, Material* material_, Texture* texture_);
 		
 		/*! Verifies that everything is setup correctly in the scene */
 		void verifySetup();
 		
+		/*! Builds the data structures used to accelerate rendering. Must be called
+		 *  after all entities have been added and before any rays are traced. */
+		void prepare();
+		
+		/*! Computes smooth-shading normals for every triangle given without vn data. Each vertex
+		 *  normal is the area-weighted average of the normals of the triangles sharing the vertex.
+		 *  Vertices which already have a normal keep it. */
+		void generateVertexNormals();
+		
+		/*! Merges vertices which lie within epsilon of each other and have the same normal and
+		 *  texture coordinates, and points the triangles at the remaining vertices. Vertices are
+		 *  found through a hash of grid cells epsilon wide. Triangles left with fewer than three
+		 *  distinct vertices are removed.
+		 * \param epsilon Largest distance between two merged vertices */
+		void weldVertices(float epsilon);
+		
+		/*! Replaces the triangles with compact meshes, one per combination of material, texture,
+		 *  and normals flag. The triangles and their vertices are deleted. */
+		void compactTriangles();
+		
 		/*! Traces a ray through the scene
 		 * \param ray The ray to shoot through the scene
 		 * \param rayPayload The associated payload data for the ray */
 		void traceRay(Ray& ray, RayPayload& rayPayload);
 		
-		/*! Apply phong illumination and shadows
+		/*! Traces a batch of rays through the scene. Every ray is tested against one object
+		 *  before moving on to the next object, so each object's data stays in cache while
+		 *  the whole batch streams past it. Results match calling traceRay on each ray.
+		 * \param rays The rays to shoot through the scene
+		 * \param rayPayloads The associated payload data, one per ray */
+		void traceBatch(std::vector<Ray>& rays, std::vector<RayPayload>& rayPayloads);
+		
+		/*! Apply phong illumination and shadows, and follow reflected and refracted rays
 		 * \param ray The ray to shoot through the scene
 		 * \param rayPayload The associated payload data for the ray
+		 * \param rng Random number generator of the pixel being shaded
+		 * \param secondaryHits If given, the hits of reflected and refracted rays are appended here
+		 * \return RGB color result */
+		Vec3f shadeRay(Ray& ray, RayPayload& rayPayload, Random& rng, std::vector<SurfaceHit>* secondaryHits = 0);
+		
+		/*! Follows the reflected and refracted rays leaving a primary hit, whose direct lighting was
+		 *  computed separately. Adding the result to the clamped direct lighting and clamping again
+		 *  gives the same color as shadeRay.
+		 * \param ray The primary ray
+		 * \param hit Shading data for the primary ray's hit
+		 * \param rng Random number generator of the pixel, after the lights were selected
+		 * \param secondaryHits If given, the hits of reflected and refracted rays are appended here
+		 * \return RGB color carried back by the reflected and refracted rays */
+		Vec3f shadeSecondary(Ray& ray, const SurfaceHit& hit, Random& rng, std::vector<SurfaceHit>* secondaryHits = 0);
+		
+		/*! Gathers the data needed to shade a ray's intersection
+		 * \param ray The ray which hit an object
+		 * \param rayPayload The associated payload data for the ray
+		 * \return Shading data for the hit */
+		SurfaceHit computeSurfaceHit(Ray& ray, RayPayload& rayPayload);
+		
+		/*! Computes the ambient color of a hit, which is present even in the absence of lights
+		 * \param hit Shading data for the hit
+		 * \return RGB color result */
+		Vec3f ambientTerm(const SurfaceHit& hit);
+		
+		/*! Computes the diffuse and specular contribution of one light at a hit, ignoring shadows
+		 * \param hit Shading data for the hit
+		 * \param sample The light and the weight of its contribution
 		 * \return RGB color result */
-		Vec3f shadeRay(Ray& ray, RayPayload& rayPayload);
+		Vec3f lightTerm(const SurfaceHit& hit, const LightSample& sample);
+		
+		/*! Determines whether a light is blocked at a hit
+		 * \param hit Shading data for the hit
+		 * \param lightIndex Index of the light
+		 * \param shadowRay The ray from the hit towards the light
+		 * \return True if the light is blocked */
+		bool isLightBlocked(const SurfaceHit& hit, int lightIndex, Ray& shadowRay);
+		
+		/*! Getter for a light
+		 * \param lightIndex Index of the light
+		 * \return Pointer to the light */
+		Light* getLight(int lightIndex) const;
+		
+		/*! Getter for the number of lights
+		 * \return Number of lights in the scene */
+		int getNumLights() const;
+		
+		/*! Finds the lights which are considered when shading a point
+		 * \param point The point to be shaded
+		 * \param lightIndices Indices of the lights are appended here */
+		void getCandidateLights(Vec3f point, std::vector<int>& lightIndices) const;
+		
+		/*! Chooses the lights used to shade a point. Only lights which contribute meaningfully
+		 *  at the point are considered, and if light sampling is enabled a fixed number of them
+		 *  is drawn with probability proportional to their unshadowed intensity.
+		 * \param point The point to be shaded
+		 * \param rng Random number generator of the pixel being shaded
+		 * \param samples The chosen lights and their weights are written here */
+		void selectLights(Vec3f point, Random& rng, std::vector<LightSample>& samples);
 		
 		// Flags which keep track of what has and has not been set
 		
 	private:
 		
+		/*! Hashes the coordinates of a cell of the grid used by weldVertices
+		 * \param x Cell index along x
+		 * \param y Cell index along y
+		 * \param z Cell index along z
+		 * \return Key of the cell */
+		static long long weldCellKey(long long x, long long y, long long z);
+		
+		/*! Shades a hit at any depth of the ray tree
+		 * \param ray The ray which hit an object
+		 * \param rayPayload The associated payload data for the ray
+		 * \param rng Random number generator of the pixel being shaded
+		 * \param depth Number of bounces between the eye and the hit
+		 * \param throughput Largest change the hit's color could make to the pixel
+		 * \param rayBudget Number of secondary rays the pixel may still trace, counted down
+		 * \param secondaryHits If given, the hits of secondary rays are appended here
+		 * \return RGB color result */
+		Vec3f shadeRay(Ray& ray, RayPayload& rayPayload, Random& rng, int depth, float throughput,
+		               int& rayBudget, std::vector<SurfaceHit>* secondaryHits);
+		
+		/*! Sums the unclamped diffuse, specular, and ambient light at a hit
+		 * \param hit Shading data for the hit
+		 * \param rng Random number generator of the pixel being shaded
+		 * \return RGB color result */
+		Vec3f directTerm(const SurfaceHit& hit, Random& rng);
+		
+		/*! Splits the light leaving a hit into reflected and refracted rays, weighted by the Fresnel
+		 *  reflectance and the opacity, and traces the heavier one first
+		 * \param ray The ray which hit an object
+		 * \param hit Shading data for the hit
+		 * \param rng Random number generator of the pixel being shaded
+		 * \param depth Number of bounces between the eye and the hit
+		 * \param throughput Largest change the hit's color could make to the pixel
+		 * \param rayBudget Number of secondary rays the pixel may still trace, counted down
+		 * \param secondaryHits If given, the hits of secondary rays are appended here
+		 * \return RGB color carried back by the rays */
+		Vec3f secondaryTerm(Ray& ray, const SurfaceHit& hit, Random& rng, int depth, float throughput,
+		                    int& rayBudget, std::vector<SurfaceHit>* secondaryHits);
+		
+		/*! Traces one reflected or refracted ray, unless it is culled, out of budget, or ended by roulette
+		 * \param ray The secondary ray
+		 * \param weight Fraction of the hit's light which the ray carries
+		 * \param rng Random number generator of the pixel being shaded
+		 * \param depth Number of bounces between the eye and the hit the ray leaves
+		 * \param throughput Largest change the hit's color could make to the pixel
+		 * \param rayBudget Number of secondary rays the pixel may still trace, counted down
+		 * \param secondaryHits If given, the hits of secondary rays are appended here
+		 * \return Weighted RGB color carried back by the ray */
+		Vec3f traceBranch(Ray& ray, float weight, Random& rng, int depth, float throughput,
+		                  int& rayBudget, std::vector<SurfaceHit>* secondaryHits);
+		
+		/*! Counts of the secondary rays traced and not traced */
+		SecondaryRayCounts secondaryCounts;
+		
 		/*! The "origin" where rays emanate from */
 		Vec3f eyePos;
 		
@@ -168,6 +404,22 @@ class Scene {
 		/*! Collection of all lights in the scene */
 		std::vector<Light*> lights;
 		
+		/*! The spheres in the scene packed eight at a time, and every other object, built by prepare() */
+		std::vector<SpherePacket> spherePackets;
+		std::vector<Object*> otherObjects;
+		
+		/*! Number of spheres in the packets */
+		int numPackedSpheres;
+		
+		/*! Spatial lookup structure for the lights, built by prepare() */
+		LightGrid lightGrid;
+		
+		/*! Settings which control how the scene is rendered */
+		RenderOptions options;
+		
+		/*! Cache shared by every texture in the scene */
+		TextureCache* textureCache;
+		
 		/*! Collection of all vertices in the scene */
 		std::vector<Vert*> verts;
 		
@@ -180,6 +432,10 @@ class Scene {
 		/*! Name of the scene */
 		std::string sceneName;
 		
+		/*! Hashes of the scene file, used to detect edits between renders */
+		uint64_t viewSignature;
+		uint64_t geometrySignature;
+		
 		/*! Flag to keep track of whether the eye has been set */
 		bool eyeSet;
 		
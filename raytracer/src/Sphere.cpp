@@ -5,68 +5,82 @@ Sphere::Sphere(Vec3f pos_, float radius_, Material* material_, Texture* texture_
 }
 
 
-// Determines whether a ray intersects the sphere. If so, returns a scalar t such that
-// ray.origin + t * ray.dir is the position on the sphere where the intersection occurs
-// Else, returns -1
+// Determines whether a ray intersects the sphere closer than any object found so far,
+// and if so records the hit in the payload
 bool Sphere::intersect(Ray& ray, RayPayload& rayPayload){
 	
+	float t = 0.f;
+	if( intersectInterval( ray, 0.f, rayPayload.getDistance(), t ) ){
+		setHit( ray, t, rayPayload );
+		return true;
+	}
+	
+	return false;
+}
+
+// Geometric form of the ray-sphere test. The ray direction has unit length, so the distance
+// from the center to the ray follows from one projection, and only one square root is needed.
+// A ray which grazes the sphere has t0 == t1 and still counts as a hit.
+bool Sphere::intersectInterval(Ray& ray, float tmin, float tmax, float& t){
+	
 	Vec3f rayOrigin = ray.getOrigin();
 	Vec3f rayDir = ray.getDir();
 	
-	float A = 1.f;
-	float B = 2.0 * Vec3f::dot(rayDir, rayOrigin - pos );
-	float C = powf((rayOrigin.x - pos.x),2.f) + powf((rayOrigin.y - pos.y),2.f) + powf((rayOrigin.z - pos.z),2.f) - radius*radius;
+	Vec3f L = pos - rayOrigin;
+	float tca = Vec3f::dot( L, rayDir );
+	float d2 = Vec3f::dot( L, L ) - tca*tca;
+	float disc = radius*radius - d2;
 	
-	float disc = B*B - 4.f*A*C;
-	
-	float t = -1;
-	if( disc >= 0 ){
-		float t1 = (-B + sqrt(disc)) / (2.0*A);
-		float t2 = (-B - sqrt(disc)) / (2.0*A);
-		
-		if( t1 < t2 && t1 >= 0 ){
-			t = t1;
-		} else if( t2 < t1 && t2 >= 0 ){
-			t = t2;
-		}
+	if( disc < 0.f ){
+		return false;
 	}
 	
-	if( t >= 0 && t < rayPayload.getDistance()){
-		rayPayload.setMaterial(material);
-		rayPayload.setDistance(t);
-		
-		if( texture != 0 && texture != NULL ){
-		
-			rayPayload.setTexture(texture);
-		
-			Vec3f pointOnSurface = rayOrigin + t * rayDir;
-			
-			float PI = 3.1415926535;
-			float phi = acosf( (pointOnSurface.z - pos.z) / radius );
-			float theta = atan2f( (pointOnSurface.y - pos.y) , (pointOnSurface.x - pos.x) );
-			if( theta < 0 ){
-				theta = theta + 2.f * PI;
-			}
+	float thc = sqrtf( disc );
+	float t0 = tca - thc;
+	float t1 = tca + thc;
+	
+	t = ( t0 >= tmin ) ? t0 : t1;
+	return ( t >= tmin && t < tmax );
+}
 
-			float u = theta / (2.f*PI);
-			float v = phi / PI;
+void Sphere::setHit(Ray& ray, float t, RayPayload& rayPayload){
+	
+	rayPayload.setMaterial(material);
+	rayPayload.setDistance(t);
+	
+	if( texture != 0 && texture != NULL ){
+	
+		rayPayload.setTexture(texture);
+	
+		Vec3f pointOnSurface = ray.getOrigin() + t * ray.getDir();
 		
-			Vec2i texIndices = texture -> getIndices(u,v);
-			rayPayload.setTextureColor( texture -> getPixelColor(texIndices) );
-			
-			
-		} else {
-			rayPayload.setTexture(0);
+		float PI = 3.1415926535f;
+		float phi = acosf( (pointOnSurface.z - pos.z) / radius );
+		float theta = atan2f( (pointOnSurface.y - pos.y) , (pointOnSurface.x - pos.x) );
+		if( theta < 0 ){
+			theta = theta + 2.f * PI;
 		}
+
+		float u = theta / (2.f*PI);
+		float v = phi / PI;
+	
+		Vec2i texIndices = texture -> getIndices(u,v);
+		rayPayload.setTextureColor( texture -> getPixelColor(texIndices) );
 		
-		return true;
+	} else {
+		rayPayload.setTexture(0);
 	}
 	
-	return false;
 }
 
-Vec3f Sphere::getUnitSurfaceNormal(Vec3f pointOnSurface){
+Vec3f Sphere::getUnitSurfaceNormal(Vec3f pointOnSurface, const RayPayload& rayPayload){
 	return Vec3f::normalize( pointOnSurface - pos );
 }
 
+Vec3f Sphere::getPos() const{
+	return pos;
+}
 
+float Sphere::getRadius() const{
+	return radius;
+}
@@ -32,10 +32,33 @@ class Sphere : public Object {
 		 * \return True if the ray intersects the sphere, false otherwise */
 		bool intersect(Ray& ray, RayPayload& rayPayload);
 		
+		/*! Determines whether a ray hits the sphere at a distance t with tmin <= t < tmax.
+		 * \param ray The ray shot out by the raytracer
+		 * \param tmin The smallest distance along the ray which counts as a hit
+		 * \param tmax Hits at this distance or further away are ignored
+		 * \param t Set to the distance along the ray to the nearest hit in the interval
+		 * \return True if the ray hits the sphere within the interval, false otherwise */
+		bool intersectInterval(Ray& ray, float tmin, float tmax, float& t);
+		
+		/*! Records a hit on the sphere in a ray's payload, looking up the texture color if there is one
+		 * \param ray The ray which hit the sphere
+		 * \param t The distance along the ray to the hit
+		 * \param rayPayload The associated payload data for the ray */
+		void setHit(Ray& ray, float t, RayPayload& rayPayload);
+		
 		/*! Determines unit normal at a particular point on the surface of the sphere.
 		 * \param pointOnSurface The point on the surface of the sphere in which to compute the normal.
+		 * \param rayPayload Payload of the ray which hit the sphere at that point
 		 * \return Unit surface normal at point on sphere */
-		Vec3f getUnitSurfaceNormal(Vec3f pointOnSurface);
+		Vec3f getUnitSurfaceNormal(Vec3f pointOnSurface, const RayPayload& rayPayload);
+		
+		/*! Getter for the position of the center of the sphere
+		 * \return The position of the sphere */
+		Vec3f getPos() const;
+		
+		/*! Getter for the radius of the sphere
+		 * \return The radius of the sphere */
+		float getRadius() const;
 		
 	private:
 		
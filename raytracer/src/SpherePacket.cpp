@@ -0,0 +1,106 @@
+#include "SpherePacket.hpp"
+#include <algorithm>
+#include <cmath>
+
+SpherePacket::SpherePacket(){
+	
+	count = 0;
+	for(int i = 0; i < WIDTH; i++){
+		centerX[i] = 0.f;
+		centerY[i] = 0.f;
+		centerZ[i] = 0.f;
+		radiusSquared[i] = -1.f;
+		spheres[i] = 0;
+	}
+	
+}
+
+bool SpherePacket::add(Sphere* sphere){
+	
+	if( count == WIDTH ){
+		return false;
+	}
+	
+	Vec3f pos = sphere->getPos();
+	centerX[count] = pos.x;
+	centerY[count] = pos.y;
+	centerZ[count] = pos.z;
+	radiusSquared[count] = sphere->getRadius() * sphere->getRadius();
+	spheres[count] = sphere;
+	count++;
+	
+	return true;
+	
+}
+
+int SpherePacket::size() const{
+	return count;
+}
+
+Sphere* SpherePacket::getSphere(int lane) const{
+	return spheres[lane];
+}
+
+// The same arithmetic as Sphere::intersectInterval, written as a branch-free loop over
+// the lanes so that the compiler turns it into vector instructions
+void SpherePacket::intersectAll(Ray& ray, float tmin, float tmax, float t[WIDTH]) const{
+	
+	const Vec3f origin = ray.getOrigin();
+	const Vec3f dir = ray.getDir();
+	
+	for(int i = 0; i < WIDTH; i++){
+		
+		float Lx = centerX[i] - origin.x;
+		float Ly = centerY[i] - origin.y;
+		float Lz = centerZ[i] - origin.z;
+		
+		float tca = Lx*dir.x + Ly*dir.y + Lz*dir.z;
+		float d2 = (Lx*Lx + Ly*Ly + Lz*Lz) - tca*tca;
+		float disc = radiusSquared[i] - d2;
+		
+		float thc = std::sqrt( std::max( disc, 0.f ) );
+		float t0 = tca - thc;
+		float t1 = tca + thc;
+		float tc = ( t0 >= tmin ) ? t0 : t1;
+		
+		tc = ( (disc >= 0.f) & (tc >= tmin) ) ? tc : tmax;
+		t[i] = std::min( tc, tmax );
+		
+	}
+	
+}
+
+int SpherePacket::intersect(Ray& ray, float tmin, float tmax, float& t) const{
+	
+	float tLane[WIDTH];
+	intersectAll( ray, tmin, tmax, tLane );
+	
+	int nearest = -1;
+	for(int i = 0; i < count; i++){
+		if( tLane[i] < tmax ){
+			tmax = tLane[i];
+			nearest = i;
+		}
+	}
+	
+	if( nearest >= 0 ){
+		t = tmax;
+	}
+	return nearest;
+	
+}
+
+int SpherePacket::occludes(Ray& ray, float tmin, float tmax, const Object* exclude) const{
+	
+	float tLane[WIDTH];
+	intersectAll( ray, tmin, tmax, tLane );
+	
+	for(int i = 0; i < count; i++){
+		if( tLane[i] < tmax && spheres[i] != exclude ){
+			return i;
+		}
+	}
+	
+	return -1;
+	
+}
@@ -0,0 +1,84 @@
+/**
+ * \author George Brown
+ *
+ * \file SpherePacket.hpp
+ * \brief Scenes made of many spheres spend most of their time in the ray-sphere test.
+ *        Packing spheres in groups of eight, with each coordinate stored in its own array,
+ *        lets one ray be tested against the whole group with vector instructions.
+ */
+
+#ifndef SPHERE_PACKET_HPP
+#define SPHERE_PACKET_HPP
+
+#include "Math.hpp"
+#include "Ray.hpp"
+#include "Object.hpp"
+#include "Sphere.hpp"
+
+/*! \class SpherePacket Class which stores up to eight spheres in structure of arrays form */
+class SpherePacket {
+	
+	public:
+		
+		/*! Number of spheres in a full packet */
+		static const int WIDTH = 8;
+		
+		/*! SpherePacket constructor. The packet starts out empty */
+		SpherePacket();
+		
+		/*! Adds a sphere to the packet
+		 * \param sphere The sphere to add
+		 * \return False if the packet was already full */
+		bool add(Sphere* sphere);
+		
+		/*! Gets the number of spheres in the packet
+		 * \return Number of spheres */
+		int size() const;
+		
+		/*! Getter for a sphere in the packet
+		 * \param lane Position of the sphere in the packet
+		 * \return Pointer to the sphere */
+		Sphere* getSphere(int lane) const;
+		
+		/*! Finds the nearest sphere in the packet which a ray hits at a distance t with tmin <= t < tmax.
+		 *  When two spheres are hit at the same distance the one added first wins, as in a sequential test.
+		 * \param ray The ray shot out by the raytracer
+		 * \param tmin The smallest distance along the ray which counts as a hit
+		 * \param tmax Hits at this distance or further away are ignored
+		 * \param t Set to the distance along the ray to the hit
+		 * \return Position of the sphere which was hit, or -1 if there was no hit */
+		int intersect(Ray& ray, float tmin, float tmax, float& t) const;
+		
+		/*! Finds any sphere in the packet which a ray hits at a distance t with tmin <= t < tmax
+		 * \param ray The ray travelling from a surface towards a light
+		 * \param tmin The smallest distance along the ray which counts as a hit
+		 * \param tmax Hits at this distance or further away are ignored
+		 * \param exclude An object which is never counted as a hit, usually the one the ray starts at
+		 * \return Position of a sphere which was hit, or -1 if there was no hit */
+		int occludes(Ray& ray, float tmin, float tmax, const Object* exclude) const;
+		
+	private:
+		
+		/*! Computes the distance to the nearest hit in the interval for every sphere, or tmax on a miss
+		 * \param ray The ray to test
+		 * \param tmin The smallest distance along the ray which counts as a hit
+		 * \param tmax Hits at this distance or further away are ignored
+		 * \param t Set to the distance for each sphere */
+		void intersectAll(Ray& ray, float tmin, float tmax, float t[WIDTH]) const;
+		
+		/*! Sphere centers and squared radii, one array per component.
+		 *  Unused lanes have a negative squared radius so that they never report a hit */
+		float centerX[WIDTH];
+		float centerY[WIDTH];
+		float centerZ[WIDTH];
+		float radiusSquared[WIDTH];
+		
+		/*! The spheres in the packet */
+		Sphere* spheres[WIDTH];
+		
+		/*! Number of spheres in the packet */
+		int count;
+		
+};
+
+#endif
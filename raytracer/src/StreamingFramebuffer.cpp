@@ -0,0 +1,68 @@
+#include "StreamingFramebuffer.hpp"
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+StreamingFramebuffer::StreamingFramebuffer(int width_, int height_, const std::string& filename_)
+	: Framebuffer(width_,height_), filename(filename_) {
+		
+	file.open( filename.c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc );
+	if( !file.is_open() ){
+		std::cout << "Error: Failed to open an output file with the given filename.\n";
+		exit(0);
+	}
+	
+	std::stringstream header;
+	header << "P6\n" << width << " " << height << "\n" << 255 << "\n";
+	file << header.str();
+	headerSize = header.str().size();
+	
+	// Writing the last byte makes the file its full size, so every tile lands inside it.
+	// Pixels which are never written read back as black
+	const std::streamoff dataSize = std::streamoff(width) * height * 3;
+	if( dataSize > 0 ){
+		file.seekp( headerSize + dataSize - 1 );
+		file.put( 0 );
+	}
+	filePos = -1;
+	
+}
+
+void StreamingFramebuffer::writeTile(int x0, int y0, int w, int h, const Vec3f* colors){
+	
+	if( w <= 0 ){
+		return;
+	}
+	rowBytes.resize( size_t(w) * 3 );
+	
+	for(int y = y0; y < y0+h; y++){
+		
+		for(int x = 0; x < w; x++){
+			const Vec3f& rgb = *colors++;
+			rowBytes[3*x] = toByte(rgb.x);
+			rowBytes[3*x+1] = toByte(rgb.y);
+			rowBytes[3*x+2] = toByte(rgb.z);
+		}
+		
+		const std::streamoff pos = headerSize + ( std::streamoff(y) * width + x0 ) * 3;
+		if( pos != filePos ){
+			file.seekp( pos );
+		}
+		file.write( reinterpret_cast<const char*>( &rowBytes[0] ), rowBytes.size() );
+		filePos = pos + rowBytes.size();
+		
+	}
+	
+	if( !file ){
+		std::cout << "Error: Failed to write to the output file " << filename << ".\n";
+		exit(0);
+	}
+	
+}
+
+void StreamingFramebuffer::finish(){
+	
+	std::cout << "Output file: " << filename << std::endl;
+	file.close();
+	
+}
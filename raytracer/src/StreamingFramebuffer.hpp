@@ -0,0 +1,60 @@
+/**
+ * \author George Brown
+ *
+ * \file StreamingFramebuffer.hpp 
+ * \brief A framebuffer which writes every finished row or tile straight into the output file,
+ *        so that memory use depends on the size of a tile rather than the size of the image.
+ */
+
+#ifndef STREAMING_FRAMEBUFFER_HPP
+#define STREAMING_FRAMEBUFFER_HPP
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include "Framebuffer.hpp"
+
+/*! \class StreamingFramebuffer Class which writes pixels out of core to a binary (P6) PPM file.
+ *  Every pixel takes exactly 3 bytes in the file, so a tile can be written in place by seeking
+ *  to each of its rows, whatever order the tiles are finished in. */
+class StreamingFramebuffer : public Framebuffer {
+	
+	public:
+		
+		/*! StreamingFramebuffer constructor. Creates the output file at its full size
+		 * \param width_ The width of the image in pixels
+		 * \param height_ The height of the image in pixels
+		 * \param filename_ The name of the PPM file the image is written to */
+		StreamingFramebuffer(int width_, int height_, const std::string& filename_);
+		
+		/*! Writes a finished rectangle of pixels to the file
+		 * \param x0 The column of the tile's upper left pixel
+		 * \param y0 The row of the tile's upper left pixel
+		 * \param w The width of the tile in pixels
+		 * \param h The height of the tile in pixels
+		 * \param colors The tile's colors in scanline order, w*h of them */
+		void writeTile(int x0, int y0, int w, int h, const Vec3f* colors);
+		
+		/*! Closes the output file */
+		void finish();
+		
+	private:
+		
+		/*! The name of the PPM file */
+		std::string filename;
+		
+		/*! The open output file */
+		std::fstream file;
+		
+		/*! Size of the PPM header, which comes before the pixel data */
+		std::streamoff headerSize;
+		
+		/*! Position the file is at, so that consecutive rows are written without seeking */
+		std::streamoff filePos;
+		
+		/*! Bytes for one row of a tile, reused between writes */
+		std::vector<unsigned char> rowBytes;
+		
+};
+
+#endif
@@ -1,15 +1,141 @@
 #include "Texture.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cerrno>
+#include <sys/stat.h>
+#include <unistd.h>
 
-Texture::Texture(){
+// Tiled texture files start with this magic number and version, followed by the image size,
+// the tile size, and the hash of the contents of the PPM image they were converted from
+static const uint32_t TILED_MAGIC = 0x52545458;
+static const uint32_t TILED_VERSION = 2;
+static const int TILED_HEADER_BYTES = 5*sizeof(uint32_t) + sizeof(uint64_t);
+
+// Continues a 64-bit FNV-1a hash over more bytes
+static uint64_t fnv1a(uint64_t hash, const char* bytes, size_t count){
+	for(size_t i = 0; i < count; i++){
+		hash = ( hash ^ (unsigned char)bytes[i] ) * 1099511628211ull;
+	}
+	return hash;
+}
+static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+Texture::Texture(TextureCache* cache_){
 	width = -1;
 	height = -1;
+	tilesX = 0;
+	cache = cache_;
+	cacheId = cache->addTexture(this);
 }
 
 
-void Texture::loadFromPpm(const std::string& filename){
+void Texture::loadFromPpm(const std::string& filename, const std::string& tileDirectory){
 	
 	std::string filepath = "../" + filename;
-	std::ifstream inputfile( filepath.c_str() );
+	
+	// Tiled files may be given directly in the scene file
+	const std::string tiledSuffix = ".tiles";
+	if( filepath.size() > tiledSuffix.size() && filepath.compare( filepath.size()-tiledSuffix.size(), tiledSuffix.size(), tiledSuffix ) == 0 ){
+		if( !openTiled( filepath, 0 ) ){
+			std::cout << "Error: Failed to open the tiled texture file with the given filename. \n";
+			exit(0);
+		}
+		return;
+	}
+	
+	// The contents are hashed rather than stamped with the modification time, which misses
+	// edits that keep the size within the same second
+	uint64_t sourceHash;
+	if( !hashFile( filepath, sourceHash ) ){
+		std::cout << "Error: Failed to open the input file with the given filename. \n";
+		exit(0);
+	}
+	
+	// Each texture path has its own tiled file, named after the image and a hash of the path,
+	// which is replaced when the image changes
+	if( mkdir( tileDirectory.c_str(), 0777 ) != 0 && errno != EEXIST ){
+		std::cout << "Error: Failed to create the tiled texture directory " << tileDirectory << ". \n";
+		exit(0);
+	}
+	char pathHash[17];
+	snprintf( pathHash, sizeof(pathHash), "%016llx", (unsigned long long)fnv1a( FNV_OFFSET, filepath.c_str(), filepath.size() ) );
+	std::string tiledPath = tileDirectory + "/" + filename.substr( filename.find_last_of('/') + 1 ) + "-" + pathHash + tiledSuffix;
+	
+	if( !openTiled( tiledPath, sourceHash ) ){
+		convertPpm( filepath, tiledPath, sourceHash );
+		if( !openTiled( tiledPath, sourceHash ) ){
+			std::cout << "Error: Failed to write the tiled texture file " << tiledPath << ". \n";
+			exit(0);
+		}
+	}
+	
+}
+
+
+bool Texture::hashFile(const std::string& path, uint64_t& hash){
+	
+	std::ifstream file( path.c_str(), std::ios::binary );
+	if( !file.is_open() ){
+		return false;
+	}
+	
+	hash = FNV_OFFSET;
+	std::vector<char> chunk( 1 << 16 );
+	while( file ){
+		file.read( &chunk[0], chunk.size() );
+		hash = fnv1a( hash, &chunk[0], file.gcount() );
+	}
+	return file.eof();
+	
+}
+
+
+bool Texture::openTiled(const std::string& tiledPath, uint64_t sourceHash){
+	
+	if( tiledFile.is_open() ){
+		tiledFile.close();
+	}
+	tiledFile.clear();
+	tiledFile.open( tiledPath.c_str(), std::ios::binary );
+	if( !tiledFile.is_open() ){
+		return false;
+	}
+	
+	uint32_t magic = 0, version = 0, w = 0, h = 0, tileSize = 0;
+	uint64_t hash = 0;
+	tiledFile.read( (char*)&magic, sizeof(magic) );
+	tiledFile.read( (char*)&version, sizeof(version) );
+	tiledFile.read( (char*)&w, sizeof(w) );
+	tiledFile.read( (char*)&h, sizeof(h) );
+	tiledFile.read( (char*)&tileSize, sizeof(tileSize) );
+	tiledFile.read( (char*)&hash, sizeof(hash) );
+	
+	if( !tiledFile || magic != TILED_MAGIC || version != TILED_VERSION || tileSize != TextureCache::TILE_SIZE ||
+	    ( sourceHash != 0 && hash != sourceHash ) ){
+		tiledFile.close();
+		return false;
+	}
+	
+	// A file cut short holds fewer tiles than its header promises
+	const int T = TextureCache::TILE_SIZE;
+	const std::streamoff expectedBytes = TILED_HEADER_BYTES + std::streamoff( (w+T-1)/T ) * ( (h+T-1)/T ) * TextureCache::TILE_BYTES;
+	tiledFile.seekg( 0, std::ios::end );
+	if( tiledFile.tellg() != expectedBytes ){
+		tiledFile.close();
+		return false;
+	}
+	
+	width = w;
+	height = h;
+	tilesX = ( width + TextureCache::TILE_SIZE - 1 ) / TextureCache::TILE_SIZE;
+	return true;
+	
+}
+
+
+void Texture::convertPpm(const std::string& ppmPath, const std::string& tiledPath, uint64_t sourceHash){
+	
+	std::ifstream inputfile( ppmPath.c_str() );
 	
 	if( inputfile.is_open() ){
 		
@@ -22,9 +148,32 @@ void Texture::loadFromPpm(const std::string& filename){
 		std::stringstream ss(headerLine);
 		ss >> header >> width >> height >> rgbMax;
 		
-		pixels.resize(height);
+		if( rgbMax > 255 ){
+			std::cout << "Error: Texture ppm files must have a maximum color value of at most 255. \n";
+			exit(0);
+		}
+		
+		// Other renders may be reading the tiled file, or converting the same image at the same time,
+		// so the file only appears under its name once it is complete
+		std::stringstream tempPath;
+		tempPath << tiledPath << ".tmp" << getpid();
+		
+		std::ofstream outputfile( tempPath.str().c_str(), std::ios::binary );
+		uint32_t fields[5] = { TILED_MAGIC, TILED_VERSION, uint32_t(width), uint32_t(height), uint32_t(TextureCache::TILE_SIZE) };
+		outputfile.write( (const char*)fields, sizeof(fields) );
+		outputfile.write( (const char*)&sourceHash, sizeof(sourceHash) );
+		
+		// Only one band of tiles is held in memory at a time
+		const int T = TextureCache::TILE_SIZE;
+		tilesX = ( width + T - 1 ) / T;
+		std::vector<unsigned char> band( tilesX * TextureCache::TILE_BYTES );
+		
 		for(int i = 0; i < height; i++){
-			pixels[i].resize(width);
+			
+			if( i % T == 0 ){
+				std::fill( band.begin(), band.end(), 0 );
+			}
+			
 			for(int j = 0; j < width; j++){
 				
 				std::string line;
@@ -36,16 +185,30 @@ void Texture::loadFromPpm(const std::string& filename){
 				linestream >> r >> g >> b;
 			
 				if( r < 0 || r > rgbMax || g < 0 || g > rgbMax || b < 0 || b > rgbMax ){
+					outputfile.close();
+					remove( tempPath.str().c_str() );
 					std::cout << "Error: In Texture ppm file, a line contains a tuple of RGB data which is not within the allowed bounds. \n";
 					exit(0);
 				}
-			
-				pixels[i][j].setRgb(r/255.f,g/255.f,b/255.f);
 				
+				unsigned char* texel = &band[ (j/T)*TextureCache::TILE_BYTES + 3*( (i%T)*T + j%T ) ];
+				texel[0] = r;
+				texel[1] = g;
+				texel[2] = b;
+				
+			}
+			
+			if( i % T == T-1 || i == height-1 ){
+				outputfile.write( (const char*)&band[0], band.size() );
 			}
 		}
 		
-		
+		outputfile.close();
+		if( !outputfile || rename( tempPath.str().c_str(), tiledPath.c_str() ) != 0 ){
+			remove( tempPath.str().c_str() );
+			std::cout << "Error: Failed to write the tiled texture file " << tiledPath << ". \n";
+			exit(0);
+		}
 		
 	} else {
 		std::cout << "Error: Failed to open the input file with the given filename. \n";
@@ -55,6 +218,19 @@ void Texture::loadFromPpm(const std::string& filename){
 }
 
 
+void Texture::readTile(int tile, unsigned char* texels){
+	
+	tiledFile.seekg( TILED_HEADER_BYTES + std::streamoff(tile) * TextureCache::TILE_BYTES );
+	tiledFile.read( (char*)texels, TextureCache::TILE_BYTES );
+	
+	if( !tiledFile ){
+		std::cout << "Error: Failed to read a tile from a tiled texture file. \n";
+		exit(0);
+	}
+	
+}
+
+
 Vec2i Texture::getIndices(float u, float v){
 
 	if( width < 0 || height < 0 ){
@@ -71,6 +247,10 @@ Vec2i Texture::getIndices(float u, float v){
 
 Vec3f Texture::getPixelColor(Vec2i indices){
 
-	return pixels[indices.x][indices.y].getRgb();
+	const int T = TextureCache::TILE_SIZE;
+	int tile = (indices.x/T)*tilesX + indices.y/T;
+	int texel = (indices.x%T)*T + indices.y%T;
+	
+	return cache->getTexel( cacheId, tile, texel );
 	
 }
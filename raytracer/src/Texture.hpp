@@ -4,6 +4,9 @@
  * \file Texture.hpp 
  * \brief Textures may be applied to objects to add interesting patterns and designs.
  *        Textures are loaded from reference images and mapped to the surface of objects.
+ *        The first time an image is loaded it is converted to a tiled file in the tiled
+ *        texture directory, and from then on tiles are read from that file through the
+ *        shared texture cache.
  */
 
 #ifndef TEXTURE_HPP
@@ -15,20 +18,26 @@
 #include <sstream>
 #include <iostream>
 
+#include <cstdint>
+
 #include "Math.hpp"
-#include "Pixel.hpp"
+#include "TextureCache.hpp"
 
 /*! \class Texture Texture class, with methods for loading textures and mapping to objects */
 class Texture {
 	
 	public:
 	
-		/*! Texture constructor */
-		Texture();
+		/*! Texture constructor
+		 * \param cache_ The cache through which the texture's tiles are looked up */
+		Texture(TextureCache* cache_);
 		
-		/*! Loads a texture file with a PPM image format
-		 * \param filename The name of the texture file to load */
-		void loadFromPpm(const std::string& filename);
+		/*! Loads a texture file with a PPM image format, or a tiled file written by an earlier load.
+		 *  A PPM image is converted to a tiled file unless one converted from the same contents exists
+		 * \param filename The name of the texture file to load
+		 * \param tileDirectory Directory holding the tiled files converted from PPM images. It is
+		 *        created if it does not exist, but its parent must */
+		void loadFromPpm(const std::string& filename, const std::string& tileDirectory);
 		
 		/*! Gets pixel coordinates mapped to by (u,v) texture coordinates
 		 * \param u The texture coordinate along the width of the image [0,1]
@@ -41,16 +50,50 @@ class Texture {
 		 * \return The RGB color of the pixel at the specified coordinates */
 		Vec3f getPixelColor(Vec2i indices);
 		
+		/*! Reads one tile from the tiled file. Tiles on the right and bottom edges are padded with black
+		 * \param tile Index of the tile, in scanline order
+		 * \param texels Set to the RGB bytes of the tile's texels, in scanline order within the tile */
+		void readTile(int tile, unsigned char* texels);
+		
 	private:
 	
+		/*! Opens a tiled file and reads its header
+		 * \param tiledPath The tiled file
+		 * \param sourceHash Hash of the contents of the PPM image it must have been converted from,
+		 *        or 0 to accept any tiled file
+		 * \return True if the file exists, is complete, and matches the hash */
+		bool openTiled(const std::string& tiledPath, uint64_t sourceHash);
+		
+		/*! Converts a PPM image to a tiled file, one band of tiles at a time. The file is written under
+		 *  a temporary name and renamed once complete, so other renders never open a partial file
+		 * \param ppmPath The PPM image
+		 * \param tiledPath The tiled file to write
+		 * \param sourceHash Hash of the contents of the PPM image, stored in the header */
+		void convertPpm(const std::string& ppmPath, const std::string& tiledPath, uint64_t sourceHash);
+		
+		/*! Hashes the contents of a file
+		 * \param path The file to hash
+		 * \param hash Set to the 64-bit FNV-1a hash of the file's bytes
+		 * \return True if the file could be read */
+		static bool hashFile(const std::string& path, uint64_t& hash);
+		
+		/*! Cache through which the tiles are looked up */
+		TextureCache* cache;
+		
+		/*! Identifier of the texture within the cache */
+		int cacheId;
+		
+		/*! The open tiled file */
+		std::ifstream tiledFile;
+		
+		/*! Number of tiles across the width of the image */
+		int tilesX;
+	
 		/*! Texture image width, in pixels */
 		int width;
 		
 		/*! Texture image height, in pixels */
 		int height;
-		
-		/*! 2D array of pixels representing the texture image */
-		std::vector< std::vector<Pixel> > pixels;
 	
 };
 
@@ -0,0 +1,377 @@
+/**
+ * \author George Brown
+ *
+ * \file TextureBench.cpp
+ * \brief Microbenchmark which compares texel fetch throughput for textures stored in scanline
+ *        order, in the tiles used by Texture, and in tiles with their texels in Morton (Z)
+ *        order. Lookups follow the paths taken by sphere mapping in several pixel
+ *        orders and by a textured triangle, as well as random texels.
+ */
+
+//	To run the benchmark, pass any number of PPM textures as arguments.
+//	e.g. "./texbench ../textures/texturebb.ppm"
+//	With no arguments it uses the shipped texture and a generated 4096x4096 texture.
+//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+
+#include "Math.hpp"
+#include "Random.hpp"
+#include "TextureCache.hpp"
+
+/*! The five bits of a texel's row or column within its tile, spread out to the even bits */
+static const unsigned short TEXEL_SPREAD[32] = {
+	0x000, 0x001, 0x004, 0x005, 0x010, 0x011, 0x014, 0x015, 0x040, 0x041, 0x044, 0x045, 0x050, 0x051, 0x054, 0x055,
+	0x100, 0x101, 0x104, 0x105, 0x110, 0x111, 0x114, 0x115, 0x140, 0x141, 0x144, 0x145, 0x150, 0x151, 0x154, 0x155
+};
+
+/*! Gets the position of a texel within a tile whose texels are stored in Morton order
+ * \param row Row of the texel within its tile
+ * \param col Column of the texel within its tile
+ * \return Index of the texel within the tile */
+static inline int swizzleTexel(int row, int col){
+	return ( TEXEL_SPREAD[row] << 1 ) | TEXEL_SPREAD[col];
+}
+
+/*! A texture held in memory in every layout */
+struct BenchTexture {
+	
+	std::string name;
+	int width;
+	int height;
+	
+	/*! RGB bytes in scanline order */
+	std::vector<unsigned char> rowMajor;
+	
+	/*! RGB bytes in tiles, with the texels of each tile in scanline order */
+	std::vector<unsigned char> tiled;
+	
+	/*! RGB bytes in tiles, with the texels of each tile in Morton order */
+	std::vector<unsigned char> swizzled;
+	
+};
+
+/*! Fills in the tiled and swizzled copies of a texture from its scanline copy */
+static void swizzle(BenchTexture& tex){
+	
+	const int T = TextureCache::TILE_SIZE;
+	int tilesX = ( tex.width + T - 1 ) / T;
+	int tilesY = ( tex.height + T - 1 ) / T;
+	tex.tiled.assign( tilesX * tilesY * TextureCache::TILE_BYTES, 0 );
+	tex.swizzled.assign( tilesX * tilesY * TextureCache::TILE_BYTES, 0 );
+	
+	for(int i = 0; i < tex.height; i++){
+		for(int j = 0; j < tex.width; j++){
+			int tile = ( (i/T)*tilesX + j/T )*TextureCache::TILE_BYTES;
+			int src = 3*( i*tex.width + j );
+			for(int c = 0; c < 3; c++){
+				tex.tiled[ tile + 3*( (i%T)*T + j%T ) + c ] = tex.rowMajor[src+c];
+				tex.swizzled[ tile + 3*swizzleTexel( i%T, j%T ) + c ] = tex.rowMajor[src+c];
+			}
+		}
+	}
+	
+}
+
+/*! Loads a P3 texture in the one-texel-per-line form read by Texture */
+static bool loadPpm(const std::string& filename, BenchTexture& tex){
+	
+	std::ifstream inputfile( filename.c_str() );
+	if( !inputfile.is_open() ){
+		return false;
+	}
+	
+	std::string headerLine, header;
+	int rgbMax;
+	std::getline( inputfile, headerLine );
+	std::stringstream ss(headerLine);
+	ss >> header >> tex.width >> tex.height >> rgbMax;
+	
+	tex.name = filename;
+	tex.rowMajor.resize( 3 * tex.width * tex.height );
+	for(int p = 0; p < tex.width * tex.height; p++){
+		int r = 0, g = 0, b = 0;
+		inputfile >> r >> g >> b;
+		tex.rowMajor[3*p] = r;
+		tex.rowMajor[3*p+1] = g;
+		tex.rowMajor[3*p+2] = b;
+	}
+	
+	swizzle(tex);
+	return true;
+	
+}
+
+/*! Generates a texture of the given size with a pattern in every channel */
+static void generate(int size, BenchTexture& tex){
+	
+	std::stringstream name;
+	name << "generated " << size << "x" << size;
+	tex.name = name.str();
+	tex.width = size;
+	tex.height = size;
+	tex.rowMajor.resize( 3 * size * size );
+	for(int p = 0; p < size * size; p++){
+		tex.rowMajor[3*p] = p % 251;
+		tex.rowMajor[3*p+1] = (p / size) % 241;
+		tex.rowMajor[3*p+2] = (p * 7) % 239;
+	}
+	
+	swizzle(tex);
+	
+}
+
+/*! Texel lookups, as (row, column) pairs, traced by a 1024x1024 view of a sphere mapped the same way as Sphere */
+static std::vector<Vec2i> spherePath(const BenchTexture& tex){
+	
+	const int N = 1024;
+	const float PI = 3.1415926535f;
+	std::vector<Vec2i> path;
+	
+	for(int y = 0; y < N; y++){
+		for(int x = 0; x < N; x++){
+			
+			// The sphere is seen from the side, so phi varies down the image and theta across it
+			float px = 2.f*(x + 0.5f)/N - 1.f;
+			float pz = 1.f - 2.f*(y + 0.5f)/N;
+			float r2 = px*px + pz*pz;
+			if( r2 >= 1.f ){
+				continue;
+			}
+			float py = -std::sqrt( 1.f - r2 );
+			
+			float phi = acosf( pz );
+			float theta = atan2f( py, px );
+			if( theta < 0 ){
+				theta = theta + 2.f * PI;
+			}
+			
+			float u = theta / (2.f*PI);
+			float v = phi / PI;
+			path.push_back( Vec2i( std::roundf( v * (tex.height-1) ), std::roundf( u * (tex.width-1) ) ) );
+			
+		}
+	}
+	
+	return path;
+	
+}
+
+/*! The same lookups as spherePath, made by a renderer which walks the image in 16x16 pixel tiles */
+static std::vector<Vec2i> sphereTilePath(const BenchTexture& tex){
+	
+	const int N = 1024;
+	const int B = 16;
+	std::vector<Vec2i> scanline = spherePath(tex);
+	std::vector<int> first( N*N + 1, 0 );
+	
+	// Finding where each pixel's lookup, if any, is in the scanline path
+	int p = 0;
+	std::vector<int> lookup( N*N, -1 );
+	for(int y = 0; y < N; y++){
+		for(int x = 0; x < N; x++){
+			float px = 2.f*(x + 0.5f)/N - 1.f;
+			float pz = 1.f - 2.f*(y + 0.5f)/N;
+			if( px*px + pz*pz < 1.f ){
+				lookup[y*N + x] = p++;
+			}
+		}
+	}
+	
+	std::vector<Vec2i> path;
+	for(int ty = 0; ty < N; ty += B){
+		for(int tx = 0; tx < N; tx += B){
+			for(int y = ty; y < ty+B; y++){
+				for(int x = tx; x < tx+B; x++){
+					if( lookup[y*N + x] >= 0 ){
+						path.push_back( scanline[ lookup[y*N + x] ] );
+					}
+				}
+			}
+		}
+	}
+	
+	return path;
+	
+}
+
+/*! The same lookups as spherePath, made column by column down the image */
+static std::vector<Vec2i> sphereColumnPath(const BenchTexture& tex){
+	
+	const int N = 1024;
+	std::vector<Vec2i> scanline = spherePath(tex);
+	std::vector< std::vector<Vec2i> > columns( N );
+	
+	int p = 0;
+	for(int y = 0; y < N; y++){
+		for(int x = 0; x < N; x++){
+			float px = 2.f*(x + 0.5f)/N - 1.f;
+			float pz = 1.f - 2.f*(y + 0.5f)/N;
+			if( px*px + pz*pz < 1.f ){
+				columns[x].push_back( scanline[p++] );
+			}
+		}
+	}
+	
+	std::vector<Vec2i> path;
+	for(int x = 0; x < N; x++){
+		path.insert( path.end(), columns[x].begin(), columns[x].end() );
+	}
+	return path;
+	
+}
+
+/*! Texel lookups traced by a 1024x1024 view of a triangle whose texture is rotated by 60 degrees */
+static std::vector<Vec2i> trianglePath(const BenchTexture& tex){
+	
+	const int N = 1024;
+	std::vector<Vec2i> path;
+	float c = 0.5f, s = 0.8660254f;
+	
+	for(int y = 0; y < N; y++){
+		for(int x = 0; x <= y; x++){
+			float a = (x + 0.5f)/N;
+			float b = (y + 0.5f)/N;
+			float u = std::min( std::max( 0.5f + c*(a-0.5f) - s*(b-0.5f), 0.f ), 1.f );
+			float v = std::min( std::max( 0.5f + s*(a-0.5f) + c*(b-0.5f), 0.f ), 1.f );
+			path.push_back( Vec2i( std::roundf( v * (tex.height-1) ), std::roundf( u * (tex.width-1) ) ) );
+		}
+	}
+	
+	return path;
+	
+}
+
+/*! Uniformly random texel lookups */
+static std::vector<Vec2i> randomPath(const BenchTexture& tex){
+	
+	Random rng(1);
+	std::vector<Vec2i> path( 1 << 20 );
+	for(int p = 0; p < path.size(); p++){
+		path[p] = Vec2i( rng.nextUInt() % tex.height, rng.nextUInt() % tex.width );
+	}
+	return path;
+	
+}
+
+/*! Fetches every texel on a path from the scanline layout
+ * \return Sum of the fetched bytes, so that the fetches cannot be optimized away */
+static uint64_t fetchRowMajor(const BenchTexture& tex, const std::vector<Vec2i>& path){
+	
+	const unsigned char* data = &tex.rowMajor[0];
+	uint64_t sum = 0;
+	for(int p = 0; p < path.size(); p++){
+		const unsigned char* rgb = data + 3*( path[p].x * tex.width + path[p].y );
+		sum += rgb[0] + rgb[1] + rgb[2];
+	}
+	return sum;
+	
+}
+
+/*! Fetches every texel on a path from the tiled layout
+ * \return Sum of the fetched bytes, so that the fetches cannot be optimized away */
+static uint64_t fetchTiled(const BenchTexture& tex, const std::vector<Vec2i>& path){
+	
+	const int T = TextureCache::TILE_SIZE;
+	const int tilesX = ( tex.width + T - 1 ) / T;
+	const unsigned char* data = &tex.tiled[0];
+	uint64_t sum = 0;
+	for(int p = 0; p < path.size(); p++){
+		unsigned int i = path[p].x, j = path[p].y;
+		const unsigned char* rgb = data + ( (i/T)*tilesX + j/T )*TextureCache::TILE_BYTES + 3*( (i%T)*T + j%T );
+		sum += rgb[0] + rgb[1] + rgb[2];
+	}
+	return sum;
+	
+}
+
+/*! Fetches every texel on a path from the swizzled layout
+ * \return Sum of the fetched bytes, so that the fetches cannot be optimized away */
+static uint64_t fetchSwizzled(const BenchTexture& tex, const std::vector<Vec2i>& path){
+	
+	const int T = TextureCache::TILE_SIZE;
+	const int tilesX = ( tex.width + T - 1 ) / T;
+	const unsigned char* data = &tex.swizzled[0];
+	uint64_t sum = 0;
+	for(int p = 0; p < path.size(); p++){
+		unsigned int i = path[p].x, j = path[p].y;
+		const unsigned char* rgb = data + ( (i/T)*tilesX + j/T )*TextureCache::TILE_BYTES + 3*swizzleTexel( i%T, j%T );
+		sum += rgb[0] + rgb[1] + rgb[2];
+	}
+	return sum;
+	
+}
+
+/*! Times the fetches along a path in every layout and prints the throughput */
+static void run(const BenchTexture& tex, const std::string& pathName, const std::vector<Vec2i>& path){
+	
+	const int repeats = std::max( 1, int( (32 << 20) / std::max( path.size(), size_t(1) ) ) );
+	uint64_t sums[3] = { 0, 0, 0 };
+	double seconds[3] = { 0.0, 0.0, 0.0 };
+	
+	for(int layout = 0; layout < 3; layout++){
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for(int r = 0; r < repeats; r++){
+			if( layout == 0 ){
+				sums[layout] += fetchRowMajor( tex, path );
+			} else if( layout == 1 ){
+				sums[layout] += fetchTiled( tex, path );
+			} else {
+				sums[layout] += fetchSwizzled( tex, path );
+			}
+		}
+		seconds[layout] = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+	}
+	
+	if( sums[0] != sums[1] || sums[0] != sums[2] ){
+		std::cout << "Error: The layouts returned different texels.\n";
+		exit(0);
+	}
+	
+	double fetches = double(path.size()) * repeats;
+	std::cout << "  " << pathName << ": row-major " << fetches / seconds[0] / 1e6 << ", tiled "
+	          << fetches / seconds[1] / 1e6 << ", swizzled " << fetches / seconds[2] / 1e6 << " Mfetch/s" << std::endl;
+	
+}
+
+int main( int argc, char **argv ){
+	
+	std::vector<BenchTexture> textures;
+	
+	if( argc > 1 ){
+		for(int i = 1; i < argc; i++){
+			textures.push_back( BenchTexture() );
+			if( !loadPpm( argv[i], textures.back() ) ){
+				std::cout << "Error: Failed to open the texture file " << argv[i] << ".\n";
+				exit(0);
+			}
+		}
+	} else {
+		textures.push_back( BenchTexture() );
+		if( !loadPpm( "../textures/texturebb.ppm", textures.back() ) ){
+			textures.pop_back();
+		}
+		textures.push_back( BenchTexture() );
+		generate( 4096, textures.back() );
+	}
+	
+	for(int t = 0; t < textures.size(); t++){
+		std::cout << textures[t].name << " (" << textures[t].width << "x" << textures[t].height << ")" << std::endl;
+		run( textures[t], "sphere, scanline order", spherePath( textures[t] ) );
+		run( textures[t], "sphere, tiled order   ", sphereTilePath( textures[t] ) );
+		run( textures[t], "sphere, column order  ", sphereColumnPath( textures[t] ) );
+		run( textures[t], "triangle              ", trianglePath( textures[t] ) );
+		run( textures[t], "random                ", randomPath( textures[t] ) );
+	}
+	
+	return 0;
+	
+}
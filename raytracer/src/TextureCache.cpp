@@ -0,0 +1,93 @@
+#include "TextureCache.hpp"
+#include "Texture.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+// The tile looked up last on the current thread. Neighbouring pixels usually look up texels of the
+// same tile, and a private copy of the tile answers them without taking the lock
+struct RecentTile {
+	const TextureCache* cache;
+	uint64_t key;
+	unsigned char texels[TextureCache::TILE_BYTES];
+};
+static thread_local RecentTile recentTile = { 0, 0, {} };
+
+TextureCache::TextureCache(long capacityBytes)
+	: hits(0), misses(0) {
+	
+	capacity = std::max( capacityBytes / TILE_BYTES, 1L );
+	
+}
+
+int TextureCache::addTexture(Texture* texture){
+	
+	std::lock_guard<std::mutex> lock(mutex);
+	textures.push_back(texture);
+	return textures.size() - 1;
+	
+}
+
+Vec3f TextureCache::getTexel(int textureId, int tile, int texel){
+	
+	uint64_t key = ( uint64_t(textureId) << 32 ) | uint32_t(tile);
+	
+	if( recentTile.cache != this || recentTile.key != key ){
+		fetchTile( key, textureId, tile );
+	} else {
+		hits.fetch_add(1,std::memory_order_relaxed);
+	}
+	
+	const unsigned char* rgb = &recentTile.texels[3*texel];
+	return Vec3f( rgb[0]/255.f, rgb[1]/255.f, rgb[2]/255.f );
+	
+}
+
+void TextureCache::fetchTile(uint64_t key, int textureId, int tile){
+	
+	std::lock_guard<std::mutex> lock(mutex);
+	
+	std::unordered_map<uint64_t, std::list<Entry>::iterator>::iterator found = index.find(key);
+	
+	if( found != index.end() ){
+		
+		// Moving the tile to the front of the list marks it as the most recently used
+		hits.fetch_add(1,std::memory_order_relaxed);
+		entries.splice( entries.begin(), entries, found->second );
+		
+	} else {
+		
+		misses.fetch_add(1,std::memory_order_relaxed);
+		
+		// Reusing the storage of the least recently used tile once the cache is full
+		if( long(entries.size()) >= capacity ){
+			index.erase( entries.back().key );
+			entries.splice( entries.begin(), entries, --entries.end() );
+		} else {
+			entries.push_front( Entry() );
+			entries.front().texels.resize( TILE_BYTES );
+		}
+		
+		entries.front().key = key;
+		textures[textureId]->readTile( tile, &entries.front().texels[0] );
+		index[key] = entries.begin();
+		
+	}
+	
+	memcpy( recentTile.texels, &entries.front().texels[0], TILE_BYTES );
+	recentTile.cache = this;
+	recentTile.key = key;
+	
+}
+
+void TextureCache::printStats(){
+	
+	std::lock_guard<std::mutex> lock(mutex);
+	
+	long lookups = hits.load(std::memory_order_relaxed) + misses.load(std::memory_order_relaxed);
+	float hitRate = lookups > 0 ? 100.f * hits.load(std::memory_order_relaxed) / float(lookups) : 0.f;
+	
+	std::cout << "Texture tile cache: " << hits.load(std::memory_order_relaxed) << " hits / " << lookups << " lookups (" << hitRate << "%), "
+	          << entries.size() << " of " << capacity << " tiles in use" << std::endl;
+	
+}
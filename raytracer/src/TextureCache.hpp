@@ -0,0 +1,94 @@
+/**
+ * \author George Brown
+ *
+ * \file TextureCache.hpp
+ * \brief Textures are stored on disk as square tiles of texels. Tiles are read the first time
+ *        they are looked up and kept in a cache shared by every texture in the scene. Once the
+ *        cache is full the least recently used tile is dropped, so memory stays bounded no
+ *        matter how many textures a scene uses.
+ */
+
+#ifndef TEXTURE_CACHE_HPP
+#define TEXTURE_CACHE_HPP
+
+#include <vector>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include "Math.hpp"
+
+class Texture;
+
+/*! \class TextureCache Class which holds the most recently used texture tiles of every texture */
+class TextureCache {
+	
+	public:
+		
+		/*! Edge length of a texture tile in texels */
+		static const int TILE_SIZE = 32;
+		
+		/*! Number of bytes in one tile, three per texel */
+		static const int TILE_BYTES = TILE_SIZE * TILE_SIZE * 3;
+		
+		/*! TextureCache constructor
+		 * \param capacityBytes Most memory the cached tiles may take up. At least one tile is always kept */
+		TextureCache(long capacityBytes);
+		
+		/*! Registers a texture whose tiles will be looked up through the cache
+		 * \param texture The texture
+		 * \return Identifier of the texture within the cache */
+		int addTexture(Texture* texture);
+		
+		/*! Looks up the color of one texel, reading its tile from disk if the tile is not cached
+		 * \param textureId Identifier returned by addTexture
+		 * \param tile Index of the tile within the texture
+		 * \param texel Index of the texel within the tile
+		 * \return The RGB color of the texel */
+		Vec3f getTexel(int textureId, int tile, int texel);
+		
+		/*! Prints how many lookups found their tile in the cache */
+		void printStats();
+		
+	private:
+		
+		/*! Copies a tile into the current thread's recently used tile, reading it from disk if it is not cached
+		 * \param key Texture identifier and tile index packed into one key
+		 * \param textureId Identifier returned by addTexture
+		 * \param tile Index of the tile within the texture */
+		void fetchTile(uint64_t key, int textureId, int tile);
+		
+		/*! \struct Entry A cached tile */
+		struct Entry {
+			
+			/*! Texture identifier and tile index packed into one key */
+			uint64_t key;
+			
+			/*! Texels of the tile */
+			std::vector<unsigned char> texels;
+			
+		};
+		
+		/*! Guards every member below except the counters, so that textures may be looked up from several threads */
+		std::mutex mutex;
+		
+		/*! Most tiles kept in the cache at once */
+		long capacity;
+		
+		/*! Cached tiles, most recently used first */
+		std::list<Entry> entries;
+		
+		/*! Position of each cached tile in the list, by key */
+		std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+		
+		/*! The registered textures, by identifier */
+		std::vector<Texture*> textures;
+		
+		/*! Lookups which found their tile in the cache, and lookups which had to read it */
+		std::atomic<long> hits;
+		std::atomic<long> misses;
+		
+};
+
+#endif
@@ -0,0 +1,153 @@
+#include "TileCache.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cctype>
+
+// Identifies the file format, and is changed whenever the format changes
+static const uint32_t TILE_CACHE_MAGIC = 0x52545443;
+static const uint32_t TILE_CACHE_VERSION = 1;
+
+TileCache::TileCache(){
+	viewSignature = 0;
+	geometrySignature = 0;
+	width = 0;
+	height = 0;
+	tileSize = 0;
+}
+
+uint64_t TileCache::hashString(const std::string& line){
+	
+	uint64_t hash = 14695981039346656037ull;
+	bool started = false;
+	bool pendingSpace = false;
+	
+	for(int i = 0; i < line.size(); i++){
+		
+		unsigned char c = line[i];
+		if( isspace(c) ){
+			pendingSpace = true;
+			continue;
+		}
+		
+		// Leading whitespace is dropped and inner runs become a single space
+		if( pendingSpace && started ){
+			hash = ( hash ^ ' ' ) * 1099511628211ull;
+		}
+		started = true;
+		pendingSpace = false;
+		hash = ( hash ^ c ) * 1099511628211ull;
+		
+	}
+	
+	return hash;
+	
+}
+
+uint64_t TileCache::hashCombine(uint64_t seed, uint64_t value){
+	return seed ^ ( value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2) );
+}
+
+Vec2i TileCache::getNumTiles() const{
+	return Vec2i( (width + tileSize - 1) / tileSize, (height + tileSize - 1) / tileSize );
+}
+
+// Helpers for reading and writing plain data and vectors of it
+template<typename T>
+static void writeValue(std::ofstream& file, const T& value){
+	file.write( reinterpret_cast<const char*>(&value), sizeof(T) );
+}
+
+template<typename T>
+static void writeVector(std::ofstream& file, const std::vector<T>& values){
+	writeValue( file, uint32_t(values.size()) );
+	if( !values.empty() ){
+		file.write( reinterpret_cast<const char*>(&values[0]), values.size()*sizeof(T) );
+	}
+}
+
+template<typename T>
+static bool readValue(std::ifstream& file, T& value){
+	file.read( reinterpret_cast<char*>(&value), sizeof(T) );
+	return bool(file);
+}
+
+template<typename T>
+static bool readVector(std::ifstream& file, std::vector<T>& values){
+	uint32_t size = 0;
+	if( !readValue(file,size) ){
+		return false;
+	}
+	values.resize(size);
+	if( size > 0 ){
+		file.read( reinterpret_cast<char*>(&values[0]), size*sizeof(T) );
+	}
+	return bool(file);
+}
+
+bool TileCache::load(const std::string& filename){
+	
+	std::ifstream file( filename.c_str(), std::ios::binary );
+	if( !file.is_open() ){
+		return false;
+	}
+	
+	uint32_t magic = 0, version = 0;
+	if( !readValue(file,magic) || !readValue(file,version) || magic != TILE_CACHE_MAGIC || version != TILE_CACHE_VERSION ){
+		return false;
+	}
+	
+	uint32_t numTiles = 0;
+	bool ok = readValue(file,viewSignature) && readValue(file,geometrySignature)
+	       && readValue(file,width) && readValue(file,height) && readValue(file,tileSize)
+	       && readVector(file,objectSignatures) && readVector(file,lightSignatures)
+	       && readValue(file,numTiles);
+	if( !ok || tileSize <= 0 ){
+		return false;
+	}
+	
+	tiles.resize(numTiles);
+	for(int t = 0; t < tiles.size(); t++){
+		char hasHits = 0;
+		ok = readValue(file,hasHits) && readValue(file,tiles[t].boxMin) && readValue(file,tiles[t].boxMax)
+		  && readVector(file,tiles[t].objects) && readVector(file,tiles[t].lights) && readVector(file,tiles[t].colors);
+		if( !ok ){
+			return false;
+		}
+		tiles[t].hasHits = hasHits;
+	}
+	
+	Vec2i dims = getNumTiles();
+	return tiles.size() == dims.x*dims.y;
+	
+}
+
+void TileCache::save(const std::string& filename) const{
+	
+	std::ofstream file( filename.c_str(), std::ios::binary );
+	if( !file.is_open() ){
+		std::cout << "Error: Failed to open the tile cache file " << filename << " for writing.\n";
+		exit(0);
+	}
+	
+	writeValue( file, TILE_CACHE_MAGIC );
+	writeValue( file, TILE_CACHE_VERSION );
+	writeValue( file, viewSignature );
+	writeValue( file, geometrySignature );
+	writeValue( file, width );
+	writeValue( file, height );
+	writeValue( file, tileSize );
+	writeVector( file, objectSignatures );
+	writeVector( file, lightSignatures );
+	writeValue( file, uint32_t(tiles.size()) );
+	
+	for(int t = 0; t < tiles.size(); t++){
+		writeValue( file, char(tiles[t].hasHits) );
+		writeValue( file, tiles[t].boxMin );
+		writeValue( file, tiles[t].boxMax );
+		writeVector( file, tiles[t].objects );
+		writeVector( file, tiles[t].lights );
+		writeVector( file, tiles[t].colors );
+	}
+	
+}
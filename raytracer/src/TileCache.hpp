@@ -0,0 +1,98 @@
+/**
+ * \author George Brown
+ *
+ * \file TileCache.hpp
+ * \brief The image can be stored as square tiles along with what each tile depended on:
+ *        the objects hit by its primary rays and by the reflection and refraction rays
+ *        which followed them, the lights considered at all of those hits, and the bounds
+ *        of the hit points. After a small edit to the scene file, only the tiles which
+ *        depended on the edited parts need to be traced again.
+ */
+
+#ifndef TILE_CACHE_HPP
+#define TILE_CACHE_HPP
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Math.hpp"
+
+/*! \struct TileRecord The colors of one tile and the scene data they depend on */
+struct TileRecord {
+	
+	/*! True if any primary ray in the tile hit an object */
+	bool hasHits;
+	
+	/*! Bounds of the points where primary, reflection, and refraction rays hit an object */
+	Vec3f boxMin;
+	Vec3f boxMax;
+	
+	/*! Indices of the objects hit by primary rays, or by the reflection and refraction rays traced
+	 *  from their hits, in increasing order. An object seen only in a reflection still colors the tile */
+	std::vector<int> objects;
+	
+	/*! Indices of the lights considered when shading the hits, in increasing order */
+	std::vector<int> lights;
+	
+	/*! Pixel colors in scanline order within the tile */
+	std::vector<Vec3f> colors;
+	
+};
+
+/*! \class TileCache Class which stores a rendered image as tiles, along with the signatures
+ *  of the scene it was rendered from */
+class TileCache {
+	
+	public:
+		
+		/*! TileCache constructor. The cache is empty until it is loaded or filled in */
+		TileCache();
+		
+		/*! Hashes a line of the scene file. Runs of whitespace are treated as a single space,
+		 *  so that reformatting a line does not count as an edit
+		 * \param line The text to hash
+		 * \return 64-bit FNV-1a hash */
+		static uint64_t hashString(const std::string& line);
+		
+		/*! Mixes a value into a hash
+		 * \param seed The hash so far
+		 * \param value The value to mix in
+		 * \return The combined hash */
+		static uint64_t hashCombine(uint64_t seed, uint64_t value);
+		
+		/*! Loads the cache from a file
+		 * \param filename The file to read
+		 * \return True if the file exists and holds a valid cache */
+		bool load(const std::string& filename);
+		
+		/*! Saves the cache to a file
+		 * \param filename The file to write */
+		void save(const std::string& filename) const;
+		
+		/*! Gets the number of tiles along each axis
+		 * \return Number of tiles across the width and height of the image */
+		Vec2i getNumTiles() const;
+		
+		/*! Hash of the camera, image, background, and render options */
+		uint64_t viewSignature;
+		
+		/*! Hash of all the geometry in the scene */
+		uint64_t geometrySignature;
+		
+		/*! Image dimensions in pixels */
+		int width;
+		int height;
+		
+		/*! Edge length of a tile in pixels */
+		int tileSize;
+		
+		/*! Signature of every object and light, by index */
+		std::vector<uint64_t> objectSignatures;
+		std::vector<uint64_t> lightSignatures;
+		
+		/*! Tiles in scanline order */
+		std::vector<TileRecord> tiles;
+		
+};
+
+#endif
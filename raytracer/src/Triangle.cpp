@@ -4,6 +4,11 @@ Triangle::Triangle(Vert* vert0_, Vert* vert1_, Vert* vert2_, Material* material_
 	: Object(material_,texture_) {
 	
 	normalsProvided = false;
+	setVerts( vert0_, vert1_, vert2_ );
+	
+}
+
+void Triangle::setVerts(Vert* vert0_, Vert* vert1_, Vert* vert2_){
 	
 	verts[0] = vert0_;
 	verts[1] = vert1_;
@@ -23,10 +28,53 @@ Triangle::Triangle(Vert* vert0_, Vert* vert1_, Vert* vert2_, Material* material_
 	C = n.z;
 	D = -Vec3f::dot(n,verts[0]->getPos());
 	
+	area = 0.5 * Vec3f::norm(n);
+	
 }
 
 bool Triangle::intersect(Ray& ray, RayPayload& rayPayload){
 	
+	float distance = 0.f;
+	Vec3f baries;
+	
+	if( intersectPlane( ray, 0.f, rayPayload.getDistance(), distance, baries ) ){
+		
+		rayPayload.setDistance(distance);
+		rayPayload.setMaterial(material);
+		rayPayload.setBarycentricCoords(baries);
+		
+		if( texture != 0 && texture != NULL ){
+			
+			rayPayload.setTexture(texture);
+			
+			Vec2f vt1 = verts[0]->getTextureCoords();
+			Vec2f vt2 = verts[1]->getTextureCoords();
+			Vec2f vt3 = verts[2]->getTextureCoords();
+			float u = baries.x*vt1.x + baries.y*vt2.x + baries.z*vt3.x;
+			float v = baries.x*vt1.y + baries.y*vt2.y + baries.z*vt3.y;
+			Vec2i texIndices = texture -> getIndices(u,v);
+			rayPayload.setTextureColor( texture -> getPixelColor(texIndices) );
+		
+		} else {
+			rayPayload.setTexture(0);
+		}
+		
+		return true;
+	}
+	
+	return false;
+
+}
+
+bool Triangle::intersectInterval(Ray& ray, float tmin, float tmax, float& t){
+	
+	Vec3f baries;
+	return intersectPlane( ray, tmin, tmax, t, baries );
+	
+}
+
+bool Triangle::intersectPlane(Ray& ray, float tmin, float tmax, float& t, Vec3f& baries){
+	
 	Vec3f rayOrigin = ray.getOrigin();
 	Vec3f rayDir = ray.getDir();
 	
@@ -34,35 +82,13 @@ bool Triangle::intersect(Ray& ray, RayPayload& rayPayload){
 	float denom = A*rayDir.x + B*rayDir.y + C*rayDir.z;
 	
 	if( fabs(denom) > 1.e-3 ){
-		float distance = numerator / denom;
-		if( distance > 0 && distance < rayPayload.getDistance() ){
+		t = numerator / denom;
+		if( t > 0 && t >= tmin && t < tmax ){
 			
-			Vec3f p = rayOrigin + distance * rayDir;
-			bool inside = isInside(p);
+			Vec3f p = rayOrigin + t * rayDir;
+			baries = getBarycentricCoords(p);
+			return baryCoordsInside(baries);
 			
-			if( inside ){
-				rayPayload.setDistance(distance);
-				rayPayload.setMaterial(material);
-				
-				if( texture != 0 && texture != NULL ){
-					
-					rayPayload.setTexture(texture);
-					
-					Vec2f vt1 = verts[0]->getTextureCoords();
-					Vec2f vt2 = verts[1]->getTextureCoords();
-					Vec2f vt3 = verts[2]->getTextureCoords();
-					Vec3f baries = getBarycentricCoords(p);
-					float u = baries.x*vt1.x + baries.y*vt2.x + baries.z*vt3.x;
-					float v = baries.x*vt1.y + baries.y*vt2.y + baries.z*vt3.y;
-					Vec2i texIndices = texture -> getIndices(u,v);
-					rayPayload.setTextureColor( texture -> getPixelColor(texIndices) );
-				
-				} else {
-					rayPayload.setTexture(0);
-				}
-				
-				return true;
-			}
 		}
 	}
 	
@@ -70,15 +96,10 @@ bool Triangle::intersect(Ray& ray, RayPayload& rayPayload){
 
 }
 
-Vec3f Triangle::getUnitSurfaceNormal(Vec3f pointOnSurface){
-	
-	if( !isInside(pointOnSurface) ){
-		std::cout << "Error: Point is not inside the triangle, so cannot compute unit surface normal.\n";
-		exit(0);
-	}
+Vec3f Triangle::getUnitSurfaceNormal(Vec3f pointOnSurface, const RayPayload& rayPayload){
 	
 	if( normalsProvided ){
-		Vec3f baries = getBarycentricCoords(pointOnSurface);
+		Vec3f baries = rayPayload.getBarycentricCoords();
 		return Vec3f::normalize( baries.x*verts[0]->getNormal() + 
 		                         baries.y*verts[1]->getNormal() + 
 		                         baries.z*verts[2]->getNormal() );
@@ -99,7 +120,6 @@ Vec3f Triangle::getBarycentricCoords(Vec3f point){
 	Vec3f e3 = point - p1;
 	Vec3f e4 = point - p2;
 			
-	float area = 0.5 * Vec3f::norm( Vec3f::cross( e1,e2) );
 	float a = 0.5 * Vec3f::norm( Vec3f::cross( e3,e4 ) );
 	float b = 0.5 * Vec3f::norm( Vec3f::cross( e4,e2 ) );
 	float c = 0.5 * Vec3f::norm( Vec3f::cross( e1,e3 ) );
@@ -114,11 +134,34 @@ Vec3f Triangle::getBarycentricCoords(Vec3f point){
 
 bool Triangle::isInside(Vec3f point){
 	
-	Vec3f baries = getBarycentricCoords(point);
+	return baryCoordsInside( getBarycentricCoords(point) );
+	
+}
+
+bool Triangle::baryCoordsInside(Vec3f baries){
+	
 	return ( baries.x + baries.y + baries.z - 1.f < 1.e-3 );
 	
 }
 
 void Triangle::setNormalsProvided(bool normalsProvided_){
-	normalsProvided_ = normalsProvided;
+	normalsProvided = normalsProvided_;
+}
+
+bool Triangle::getNormalsProvided() const{
+	return normalsProvided;
+}
+
+Vert* Triangle::getVert(int i) const{
+	return verts[i];
+}
+
+Vec3f Triangle::getAreaWeightedNormal() const{
+	
+	Vec3f p0 = verts[0]->getPos();
+	Vec3f p1 = verts[1]->getPos();
+	Vec3f p2 = verts[2]->getPos();
+	
+	return Vec3f::cross( p1 - p0, p2 - p0 );
+	
 }
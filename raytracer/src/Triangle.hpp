@@ -33,27 +33,71 @@ class Triangle : public Object {
 		 * \return True if the ray intersects the triangle, false otherwise */
 		bool intersect(Ray& ray, RayPayload& rayPayload);
 		
+		/*! Determines whether a ray hits the triangle at a distance t with tmin <= t < tmax.
+		 * \param ray The ray shot out by the raytracer
+		 * \param tmin The smallest distance along the ray which counts as a hit
+		 * \param tmax Hits at this distance or further away are ignored
+		 * \param t Set to the distance along the ray to the hit
+		 * \return True if the ray hits the triangle within the interval, false otherwise */
+		bool intersectInterval(Ray& ray, float tmin, float tmax, float& t);
+		
 		/*! Determines the barycentric coordinates in the triangle for a given point 
 		 * \param point A point in 3D space
 		 * \return The barycentric coordinates as a 3D float vec */
 		Vec3f getBarycentricCoords(Vec3f point);
 		
-		/*! Determines unit normal of the triangle.
+		/*! Determines unit normal of the triangle. When vertex normals are provided they are
+		 *  interpolated with the barycentric coordinates stored in the payload by intersect.
 		 * \param pointOnSurface The point on the surface of the triangle
+		 * \param rayPayload Payload of the ray which hit the triangle at that point
 		 * \return Unit surface normal of the triangle */
-		Vec3f getUnitSurfaceNormal(Vec3f pointOnSurface);
+		Vec3f getUnitSurfaceNormal(Vec3f pointOnSurface, const RayPayload& rayPayload);
 		
 		/*! Helper function for determining whether a point is inside of the triangle
 		 * \param point A point in 3D space
 		 * \return True if the point is inside the triangle, false otherwise */
 		bool isInside(Vec3f point);
+		
+		/*! Helper function for determining whether barycentric coordinates lie inside of the triangle
+		 * \param baries Barycentric coordinates of a point in the plane of the triangle
+		 * \return True if the point is inside the triangle, false otherwise */
+		static bool baryCoordsInside(Vec3f baries);
 	
 		/*! Sets the conditional flag for the vertex normals being provided
 		 * \param normalsProvided_ Conditional flag status to set */
 		void setNormalsProvided(bool normalsProvided_);
+		
+		/*! Getter for the conditional flag for the vertex normals being provided
+		 * \return True if the vertex normals are provided */
+		bool getNormalsProvided() const;
+		
+		/*! Getter for a vertex of the triangle
+		 * \param i Index of the vertex (0, 1, or 2)
+		 * \return Pointer to the vertex */
+		Vert* getVert(int i) const;
+		
+		/*! Replaces the vertices of the triangle and recomputes its plane
+		 * \param vert0_ The first vertex of the triangle
+		 * \param vert1_ The second vertex of the triangle
+		 * \param vert2_ The third vertex of the triangle */
+		void setVerts(Vert* vert0_, Vert* vert1_, Vert* vert2_);
+		
+		/*! Computes the triangle normal scaled by twice the triangle's area,
+		 *  used to weight the triangle's share of an averaged vertex normal
+		 * \return Area-weighted triangle normal */
+		Vec3f getAreaWeightedNormal() const;
 	
 	private:
 	
+		/*! Intersects a ray with the triangle's plane, then tests whether the point lies in the triangle
+		 * \param ray The ray shot out by the raytracer
+		 * \param tmin The smallest distance along the ray which counts as a hit
+		 * \param tmax Hits at this distance or further away are ignored
+		 * \param t Set to the distance along the ray to the hit
+		 * \param baries Set to the barycentric coordinates of the hit
+		 * \return True if the ray hits the triangle within the interval, false otherwise */
+		bool intersectPlane(Ray& ray, float tmin, float tmax, float& t, Vec3f& baries);
+	
 		/*! Triangle normal */
 		Vec3f normal;
 		
@@ -63,6 +107,9 @@ class Triangle : public Object {
 		/*! Precomputed values used for ray-triangle interactions */
 		float A, B, C, D;
 		
+		/*! Precomputed area of the triangle, used for barycentric coordinates */
+		float area;
+		
 		/*! Conditional flag which is true if the vertex normals are provided */
 		bool normalsProvided;
 	
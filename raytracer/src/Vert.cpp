@@ -2,7 +2,7 @@
 #include <iostream>
 
 Vert::Vert(Vec3f pos_)
-	: pos(pos_){
+	: pos(pos_), normalSet(false){
 }
 
 Vec3f Vert::getPos() const{
@@ -13,6 +13,10 @@ Vec3f Vert::getNormal() const{
 	return normal;
 }
 		
+bool Vert::hasNormal() const{
+	return normalSet;
+}
+
 Vec2f Vert::getTextureCoords() const{
 	return textureCoords;
 }
@@ -23,4 +27,14 @@ void Vert::setTextureCoords(Vec2f coords_){
 
 void Vert::setNormal(Vec3f normal_){
 	normal = normal_;
+	normalSet = true;
+}
+
+bool Vert::hasSameAttributes(const Vert& other) const{
+	
+	if( normalSet != other.normalSet || textureCoords.x != other.textureCoords.x || textureCoords.y != other.textureCoords.y ){
+		return false;
+	}
+	return !normalSet || ( normal.x == other.normal.x && normal.y == other.normal.y && normal.z == other.normal.z );
+	
 }
@@ -29,6 +29,10 @@ class Vert {
 		 * \return Normal of the vertex */
 		Vec3f getNormal() const;
 		
+		/*! Checks whether a normal has been set for the vertex
+		 * \return True if the vertex has a normal */
+		bool hasNormal() const;
+		
 		/*! Getter for vert texture coords
 		 * \return Texture coordiantes of the vertex */
 		Vec2f getTextureCoords() const;
@@ -40,6 +44,12 @@ class Vert {
 		/*! Setter for the vertex normal
 		 * \param normal_ Normal to set for the vertex */
 		void setNormal(Vec3f normal_);
+		
+		/*! Checks whether another vertex has the same normal and texture coordinates, so that
+		 *  the two may be merged into one without changing the shading of either
+		 * \param other The vertex to compare with
+		 * \return True if the normals and texture coordinates match */
+		bool hasSameAttributes(const Vert& other) const;
 	
 	private:
 	
@@ -49,6 +59,9 @@ class Vert {
 		/*! Vertex normal */
 		Vec3f normal;
 		
+		/*! Flag which is true once the vertex normal has been set */
+		bool normalSet;
+		
 		/*! Vertex texture coordinates */
 		Vec2f textureCoords;
 	
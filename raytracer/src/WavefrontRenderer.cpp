@@ -0,0 +1,145 @@
+#include "WavefrontRenderer.hpp"
+#include <algorithm>
+
+WavefrontRenderer::WavefrontRenderer(Scene& scene_, Window& window_, int width_)
+	: scene(scene_), window(window_), width(width_) {}
+
+// Spreads the lower 10 bits of a number out so that there are two zero bits between each of them
+static uint64_t expandBits(uint64_t v){
+	v = (v | (v << 16)) & 0x030000FFull;
+	v = (v | (v <<  8)) & 0x0300F00Full;
+	v = (v | (v <<  4)) & 0x030C30C3ull;
+	v = (v | (v <<  2)) & 0x09249249ull;
+	return v;
+}
+
+// Quantizes a coordinate to 10 bits within the range [lo,hi]
+static uint64_t quantize(float x, float lo, float hi){
+	if( hi <= lo ){
+		return 0;
+	}
+	float t = (x - lo) / (hi - lo);
+	return uint64_t( std::min( std::max( t, 0.f ), 1.f ) * 1023.f );
+}
+
+uint64_t WavefrontRenderer::octant(Vec3f dir){
+	return ( dir.x < 0.f ? 1 : 0 ) | ( dir.y < 0.f ? 2 : 0 ) | ( dir.z < 0.f ? 4 : 0 );
+}
+
+uint64_t WavefrontRenderer::morton(Vec3f point, Vec3f boxMin, Vec3f boxMax){
+	return ( expandBits( quantize(point.x, boxMin.x, boxMax.x) ) << 2 )
+	     | ( expandBits( quantize(point.y, boxMin.y, boxMax.y) ) << 1 )
+	     |   expandBits( quantize(point.z, boxMin.z, boxMax.z) );
+}
+
+void WavefrontRenderer::renderBatch(const std::vector<Vec2i>& pixelCoords, std::vector<Vec3f>& colors){
+	
+	const int numPixels = pixelCoords.size();
+	colors.assign( numPixels, scene.getBkgColor() );
+	
+	// Stage 1: primary rays share the eye as their origin, so they are ordered by direction.
+	// Rays heading the same way are traced one after the other and touch the same objects.
+	primaryRays.clear();
+	rayKeys.resize( numPixels );
+	rayOrder.resize( numPixels );
+	for(int p = 0; p < numPixels; p++){
+		primaryRays.push_back( window.getPrimaryRay( pixelCoords[p] ) );
+		Vec3f dir = primaryRays[p].getDir();
+		rayKeys[p] = ( octant(dir) << 30 ) | morton( dir, Vec3f(-1,-1,-1), Vec3f(1,1,1) );
+		rayOrder[p] = p;
+	}
+	std::sort( rayOrder.begin(), rayOrder.end(), [this](int a, int b){
+		return rayKeys[a] < rayKeys[b] || ( rayKeys[a] == rayKeys[b] && a < b );
+	});
+	
+	rays.clear();
+	for(int r = 0; r < numPixels; r++){
+		rays.push_back( primaryRays[ rayOrder[r] ] );
+	}
+	rayPayloads.assign( numPixels, RayPayload() );
+	scene.traceBatch( rays, rayPayloads );
+	
+	// Stage 2: surface data and light selection for every ray which hit something. Each pixel
+	// draws its random numbers from the same seed as in Image::draw, so it selects the same lights.
+	hits.clear();
+	hitPixels.clear();
+	hitRays.clear();
+	hitRngs.clear();
+	hitSampleStart.clear();
+	samples.clear();
+	static thread_local std::vector<LightSample> pixelSamples;
+	for(int r = 0; r < numPixels; r++){
+		
+		if( rayPayloads[r].getMaterial() == 0 || rayPayloads[r].getMaterial() == NULL ){
+			continue;
+		}
+		
+		const Vec2i& pixel = pixelCoords[ rayOrder[r] ];
+		Random rng( pixel.y*width + pixel.x );
+		
+		hits.push_back( scene.computeSurfaceHit( rays[r], rayPayloads[r] ) );
+		hitPixels.push_back( rayOrder[r] );
+		hitSampleStart.push_back( samples.size() );
+		
+		scene.selectLights( hits.back().point, rng, pixelSamples );
+		samples.insert( samples.end(), pixelSamples.begin(), pixelSamples.end() );
+		
+		// Reflected and refracted rays draw from where light selection left the generator
+		hitRays.push_back( r );
+		hitRngs.push_back( rng );
+		
+	}
+	hitSampleStart.push_back( samples.size() );
+	
+	// Stage 3: one shadow ray per light sample. The rays are bucketed by light and direction
+	// octant with a counting sort. Being stable, it keeps the hits' spatial order within each
+	// bucket, so consecutive queries start from nearby points and travel the same way towards
+	// the same light, and are likely to be blocked by the same object.
+	const int numBuckets = 8*scene.getNumLights();
+	bucketStart.assign( numBuckets+1, 0 );
+	shadowBuckets.resize( samples.size() );
+	for(int h = 0; h < hits.size(); h++){
+		for(int s = hitSampleStart[h]; s < hitSampleStart[h+1]; s++){
+			int light = samples[s].light;
+			Ray shadowRay = scene.getLight(light) -> computeShadowRay( hits[h].point );
+			shadowBuckets[s] = 8*light + octant( shadowRay.getDir() );
+			bucketStart[ shadowBuckets[s] + 1 ]++;
+		}
+	}
+	for(int k = 0; k < numBuckets; k++){
+		bucketStart[k+1] += bucketStart[k];
+	}
+	
+	shadowRecords.resize( samples.size() );
+	for(int h = 0; h < hits.size(); h++){
+		for(int s = hitSampleStart[h]; s < hitSampleStart[h+1]; s++){
+			ShadowRecord& record = shadowRecords[ bucketStart[ shadowBuckets[s] ]++ ];
+			record.sample = s;
+			record.hit = h;
+		}
+	}
+	
+	blocked.assign( samples.size(), 0 );
+	for(int i = 0; i < shadowRecords.size(); i++){
+		const ShadowRecord& record = shadowRecords[i];
+		const SurfaceHit& hit = hits[record.hit];
+		int light = samples[record.sample].light;
+		Ray shadowRay = scene.getLight(light) -> computeShadowRay( hit.point );
+		blocked[record.sample] = scene.isLightBlocked( hit, light, shadowRay );
+	}
+	
+	// Stage 4: the contributions are added up in the same order as Scene::shadeRay, so that
+	// the floating point result matches it exactly. Reflected and refracted rays are followed
+	// one pixel at a time from here.
+	for(int h = 0; h < hits.size(); h++){
+		Vec3f Ilam = scene.ambientTerm( hits[h] );
+		for(int s = hitSampleStart[h]; s < hitSampleStart[h+1]; s++){
+			if( !blocked[s] ){
+				Ilam = Ilam + scene.lightTerm( hits[h], samples[s] );
+			}
+		}
+		Vec3f color = Vec3f::clamp(Ilam,0,1);
+		colors[ hitPixels[h] ] = Vec3f::clamp( color + scene.shadeSecondary( rays[ hitRays[h] ], hits[h], hitRngs[h] ), 0, 1 );
+	}
+	
+}
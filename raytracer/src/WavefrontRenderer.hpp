@@ -0,0 +1,91 @@
+/**
+ * \author George Brown
+ *
+ * \file WavefrontRenderer.hpp
+ * \brief Renders pixels in large batches instead of one at a time. Each stage of the
+ *        pipeline (primary rays, surface data, shadow rays, accumulation) runs over the
+ *        whole batch before the next one starts, and the rays of each stage are sorted
+ *        so that neighbouring rays in memory travel through the same part of the scene.
+ */
+
+#ifndef WAVEFRONT_RENDERER_HPP
+#define WAVEFRONT_RENDERER_HPP
+
+#include <vector>
+#include <cstdint>
+#include "Math.hpp"
+#include "Ray.hpp"
+#include "Scene.hpp"
+#include "Window.hpp"
+
+/*! \class WavefrontRenderer Class which renders batches of pixels stage by stage.
+ *  The result is identical to shading each pixel with Scene::traceRay and Scene::shadeRay. */
+class WavefrontRenderer {
+	
+	public:
+		
+		/*! WavefrontRenderer constructor
+		 * \param scene_ The scene to render
+		 * \param window_ The window through which the scene is viewed
+		 * \param width_ The width of the image in pixels, used to seed each pixel's random numbers */
+		WavefrontRenderer(Scene& scene_, Window& window_, int width_);
+		
+		/*! Renders a batch of pixels
+		 * \param pixelCoords The coordinates of the pixels in the batch
+		 * \param colors Set to the color of each pixel, in the same order as pixelCoords */
+		void renderBatch(const std::vector<Vec2i>& pixelCoords, std::vector<Vec3f>& colors);
+		
+	private:
+		
+		/*! \struct ShadowRecord A shadow ray waiting to be traced */
+		struct ShadowRecord {
+			
+			/*! Index of the light sample this ray belongs to */
+			int sample;
+			
+			/*! Index of the hit the ray starts at */
+			int hit;
+			
+		};
+		
+		/*! Computes the octant of a direction, one bit per axis
+		 * \param dir A direction
+		 * \return Number in the range 0-7 */
+		static uint64_t octant(Vec3f dir);
+		
+		/*! Computes the 30-bit Morton code of a point within a bounding box
+		 * \param point The point
+		 * \param boxMin The minimum corner of the box
+		 * \param boxMax The maximum corner of the box
+		 * \return The Morton code of the point's 10-bit quantized coordinates */
+		static uint64_t morton(Vec3f point, Vec3f boxMin, Vec3f boxMax);
+		
+		/*! The scene being rendered */
+		Scene& scene;
+		
+		/*! The viewing window */
+		Window& window;
+		
+		/*! The width of the image in pixels */
+		int width;
+		
+		/*! Per-batch storage, kept between batches to avoid reallocating it */
+		std::vector<Ray> primaryRays;
+		std::vector<Ray> rays;
+		std::vector<RayPayload> rayPayloads;
+		std::vector<uint64_t> rayKeys;
+		std::vector<int> rayOrder;
+		std::vector<SurfaceHit> hits;
+		std::vector<int> hitPixels;
+		std::vector<int> hitRays;
+		std::vector<Random> hitRngs;
+		std::vector<int> hitSampleStart;
+		std::vector<LightSample> samples;
+		std::vector<int> shadowBuckets;
+		std::vector<int> bucketStart;
+		std::vector<char> blocked;
+		std::vector<ShadowRecord> shadowRecords;
+		
+};
+
+#endif
@@ -43,6 +43,11 @@ Vec3f Window::pixelToWindow(Vec2i pixelCoords){
 	return ul + pixelCoords.x*dh + pixelCoords.y*dv;
 }
 
+Ray Window::getPrimaryRay(Vec2i pixelCoords){
+	Vec3f viewDir = Vec3f::normalize( pixelToWindow(pixelCoords) - origin );
+	return Ray(origin,viewDir);
+}
+
 
 
 
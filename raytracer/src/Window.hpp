@@ -11,6 +11,7 @@
 
 #include "Math.hpp"
 #include "Scene.hpp"
+#include "Ray.hpp"
 #include <iostream>
 
 /*! \class Window Class which defines the viewing window */
@@ -26,6 +27,11 @@ class Window {
 		 * \param pixelCoordinates The pixel coordinates in an image
 		 * \return 3D spatial coordinates in the viewing window plane */
 		Vec3f pixelToWindow(Vec2i pixelCoords);
+		
+		/*! Computes the ray which is shot from the eye through a pixel
+		 * \param pixelCoords The pixel coordinates in an image
+		 * \return The primary ray for the pixel */
+		Ray getPrimaryRay(Vec2i pixelCoords);
 	
 	private:
 	
@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 #include <tuple>
+#include <chrono>
 
 
 #include "Math.hpp"
@@ -42,15 +43,20 @@ int main( int argc, char **argv ){
 	// Constructing the viewing window
 	Window window(scene);
 	
-	// Creating a blank canvas
-	Image image(scene.getEnvDims());
+	// Creating a blank canvas, which saves the image to a PPM file named after the scene
+	std::string outputFilename = scene.getSceneName() + ".ppm";
+	Image image(scene.getEnvDims(), scene.getRenderOptions(), outputFilename);
 	
 	// Drawing the image using ray tracing
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 	image.draw(scene,window);
+	std::cout << "Render time: " << std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() << " s" << std::endl;
+	scene.printShadowCacheStats();
+	scene.printTextureCacheStats();
+	scene.printSecondaryRayStats();
 	
 	// Saving the image to file in PPM format
-	std::string outputFilename = scene.getSceneName() + ".ppm";
-	image.saveToPpm(outputFilename);
+	image.saveToPpm();
 
 	return 0;
 
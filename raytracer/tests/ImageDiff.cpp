@@ -0,0 +1,183 @@
+/**
+ * \author George Brown
+ *
+ * \file ImageDiff.cpp
+ * \brief Compares a rendered image against a golden image for the regression tests. The
+ *        images match if every pixel is equal, or, when a PSNR tolerance is given, if
+ *        the peak signal to noise ratio is at least the tolerance. When they do not
+ *        match, an image marking the differing pixels is written.
+ */
+
+//	Usage:
+//	"./imagediff <image.ppm> <golden.ppm> <exact|min psnr in dB> <diff.ppm>"
+//	  exits with 0 if the images match and 1 if they do not, or if either cannot be read.
+//	"./imagediff --convert <image.ppm> <out.ppm>"
+//	  rewrites an image as a binary (P6) PPM, which is how golden images are stored.
+//
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+
+/*! \struct PpmImage An 8-bit RGB image */
+struct PpmImage {
+	
+	/*! Width and height in pixels */
+	int width;
+	int height;
+	
+	/*! Three bytes per pixel, row by row */
+	std::vector<unsigned char> rgb;
+	
+};
+
+/*! Reads the next header value of a PPM file, skipping whitespace and comments
+ * \param file The open file
+ * \param value Set to the value
+ * \return True if a value was read */
+static bool readHeaderValue(std::ifstream& file, int& value){
+	
+	while( file.good() ){
+		int c = file.peek();
+		if( c == '#' ){
+			std::string comment;
+			std::getline( file, comment );
+		} else if( isspace(c) ){
+			file.get();
+		} else {
+			break;
+		}
+	}
+	return bool( file >> value );
+	
+}
+
+/*! Reads an ASCII (P3) or binary (P6) PPM file with a maximum value of 255
+ * \param filename Path of the file
+ * \param image Set to the image
+ * \return True if the file was read */
+static bool readPpm(const std::string& filename, PpmImage& image){
+	
+	std::ifstream file( filename.c_str(), std::ios::binary );
+	std::string magic;
+	int maxValue = 0;
+	if( !( file >> magic ) || ( magic != "P3" && magic != "P6" ) ||
+	    !readHeaderValue( file, image.width ) || !readHeaderValue( file, image.height ) ||
+	    !readHeaderValue( file, maxValue ) || maxValue != 255 || image.width <= 0 || image.height <= 0 ){
+		std::cout << "Error: " << filename << " is not a PPM image with a maximum value of 255.\n";
+		return false;
+	}
+	
+	image.rgb.resize( 3 * image.width * image.height );
+	if( magic == "P6" ){
+		file.get();
+		file.read( (char*)&image.rgb[0], image.rgb.size() );
+	} else {
+		for(int i = 0; i < image.rgb.size() && file.good(); i++){
+			int value = 0;
+			file >> value;
+			image.rgb[i] = (unsigned char)value;
+		}
+	}
+	
+	if( !file ){
+		std::cout << "Error: " << filename << " ends before all of its pixels.\n";
+		return false;
+	}
+	return true;
+	
+}
+
+/*! Writes a binary (P6) PPM file
+ * \param filename Path of the file
+ * \param image The image
+ * \return True if the file was written */
+static bool writePpm(const std::string& filename, const PpmImage& image){
+	
+	std::ofstream file( filename.c_str(), std::ios::binary );
+	file << "P6\n" << image.width << " " << image.height << "\n255\n";
+	file.write( (const char*)&image.rgb[0], image.rgb.size() );
+	return bool( file );
+	
+}
+
+int main( int argc, char **argv ){
+	
+	if( argc == 4 && std::string( argv[1] ) == "--convert" ){
+		PpmImage image;
+		return ( readPpm( argv[2], image ) && writePpm( argv[3], image ) ) ? 0 : 1;
+	}
+	
+	if( argc != 5 ){
+		std::cout << "Usage: ./imagediff <image.ppm> <golden.ppm> <exact|min psnr in dB> <diff.ppm>\n"
+		          << "       ./imagediff --convert <image.ppm> <out.ppm>\n";
+		return 1;
+	}
+	
+	PpmImage image, golden;
+	if( !readPpm( argv[1], image ) || !readPpm( argv[2], golden ) ){
+		return 1;
+	}
+	if( image.width != golden.width || image.height != golden.height ){
+		std::cout << "Image is " << image.width << "x" << image.height << " but the golden image is "
+		          << golden.width << "x" << golden.height << "\n";
+		return 1;
+	}
+	
+	const bool exact = ( std::string( argv[3] ) == "exact" );
+	const double minPsnr = exact ? 0.0 : atof( argv[3] );
+	
+	long differing = 0;
+	int maxDifference = 0;
+	double squaredError = 0.0;
+	for(int p = 0; p < image.width * image.height; p++){
+		bool differs = false;
+		for(int c = 0; c < 3; c++){
+			int d = abs( int( image.rgb[3*p+c] ) - int( golden.rgb[3*p+c] ) );
+			squaredError += double(d) * d;
+			maxDifference = std::max( maxDifference, d );
+			differs = differs || ( d != 0 );
+		}
+		differing += differs;
+	}
+	
+	double mse = squaredError / image.rgb.size();
+	double psnr = ( mse > 0.0 ) ? 10.0 * log10( 255.0 * 255.0 / mse ) : INFINITY;
+	bool pass = exact ? ( differing == 0 ) : ( psnr >= minPsnr );
+	
+	std::cout << "Pixels differing: " << differing << " of " << image.width * image.height
+	          << ", largest difference: " << maxDifference << ", PSNR: " << psnr << " dB"
+	          << ( exact ? " (exact match required)" : "" ) << "\n";
+	
+	if( !pass ){
+		
+		// Matching pixels are shown dimmed, and differing pixels in red, brighter for larger differences
+		PpmImage diff = golden;
+		for(int p = 0; p < diff.width * diff.height; p++){
+			int d = 0;
+			for(int c = 0; c < 3; c++){
+				d = std::max( d, abs( int( image.rgb[3*p+c] ) - int( golden.rgb[3*p+c] ) ) );
+			}
+			if( d == 0 ){
+				for(int c = 0; c < 3; c++){
+					diff.rgb[3*p+c] = golden.rgb[3*p+c] / 4;
+				}
+			} else {
+				diff.rgb[3*p] = (unsigned char)( 128 + 127 * d / maxDifference );
+				diff.rgb[3*p+1] = 0;
+				diff.rgb[3*p+2] = 0;
+			}
+		}
+		writePpm( argv[4], diff );
+		std::cout << "Wrote the differing pixels to " << argv[4] << "\n";
+		
+	}
+	
+	return pass ? 0 : 1;
+	
+}
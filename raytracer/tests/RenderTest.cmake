@@ -0,0 +1,79 @@
+# Renders one scene and compares it against its golden image. Run by CTest as
+#   cmake -D RAYTRACER=... -D IMAGEDIFF=... -D SCENE=... -D NAME=... -D FLAGS=... -D TOLERANCE=...
+#         -D GOLDEN=... -D OUTPUT_DIR=... -D SOURCE_DIR=... -P RenderTest.cmake
+#
+# FLAGS holds the raytracer's flags separated by spaces. The scene is rendered at a reduced
+# size, at most MAX_WIDTH pixels wide, from a copy of the scene file in OUTPUT_DIR. TOLERANCE is "exact", or the smallest PSNR in dB which passes.
+# When a test fails, OUTPUT_DIR/NAME.diff.ppm marks the differing pixels. The render time
+# is written to OUTPUT_DIR/NAME.time.
+#
+# With the environment variable RAYTRACER_UPDATE_GOLDENS set, the tests which render with
+# no flags store their image as the new golden image instead of comparing against it.
+
+set(MAX_WIDTH 200)
+separate_arguments(FLAGS)
+
+# The raytracer reports errors on stdout and still exits with 0, so its output is checked
+# as well as its exit code.
+function(fail message)
+	message(FATAL_ERROR "${NAME}: ${message}")
+endfunction()
+
+file(MAKE_DIRECTORY ${OUTPUT_DIR})
+file(READ ${SCENE} sceneText)
+if(NOT sceneText MATCHES "imsize[ \t]+([0-9]+)[ \t]+([0-9]+)")
+	fail("${SCENE} has no imsize line")
+endif()
+set(width ${CMAKE_MATCH_1})
+set(height ${CMAKE_MATCH_2})
+if(width GREATER MAX_WIDTH)
+	math(EXPR height "${height} * ${MAX_WIDTH} / ${width}")
+	set(width ${MAX_WIDTH})
+endif()
+string(REGEX REPLACE "imsize[ \t]+[0-9]+[ \t]+[0-9]+" "imsize ${width} ${height}" sceneText "${sceneText}")
+
+set(sceneCopy ${OUTPUT_DIR}/${NAME}.txt)
+set(image ${OUTPUT_DIR}/${NAME}.ppm)
+file(WRITE ${sceneCopy} "${sceneText}")
+file(REMOVE ${image} ${OUTPUT_DIR}/${NAME}.diff.ppm)
+
+# Textures are loaded from the parent of the working directory, as when running from a build
+# directory next to the scenes. Their tiled copies are kept in OUTPUT_DIR, out of the source tree
+execute_process(
+	COMMAND ${RAYTRACER} ${sceneCopy} ${FLAGS} --texture-tile-dir ${OUTPUT_DIR}/texture-tiles
+	WORKING_DIRECTORY ${SOURCE_DIR}/tests
+	OUTPUT_VARIABLE output
+	ERROR_VARIABLE output
+	RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0 OR output MATCHES "Error" OR NOT EXISTS ${image})
+	fail("the render failed:\n${output}")
+endif()
+
+if(output MATCHES "Render time: ([^ ]+) s")
+	file(WRITE ${OUTPUT_DIR}/${NAME}.time "${CMAKE_MATCH_1}\n")
+	message("Render time: ${CMAKE_MATCH_1} s")
+endif()
+
+if(DEFINED ENV{RAYTRACER_UPDATE_GOLDENS} AND "${FLAGS}" STREQUAL "")
+	execute_process(COMMAND ${IMAGEDIFF} --convert ${image} ${GOLDEN} RESULT_VARIABLE result)
+	if(NOT result EQUAL 0)
+		fail("could not write ${GOLDEN}")
+	endif()
+	message("Updated ${GOLDEN}")
+	return()
+endif()
+
+if(NOT EXISTS ${GOLDEN})
+	fail("${GOLDEN} does not exist. Run with RAYTRACER_UPDATE_GOLDENS=1 to create it.")
+endif()
+
+execute_process(
+	COMMAND ${IMAGEDIFF} ${image} ${GOLDEN} ${TOLERANCE} ${OUTPUT_DIR}/${NAME}.diff.ppm
+	OUTPUT_VARIABLE comparison
+	RESULT_VARIABLE result
+)
+message("${comparison}")
+if(NOT result EQUAL 0)
+	fail("the image does not match ${GOLDEN}")
+endif()
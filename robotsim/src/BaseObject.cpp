@@ -6,7 +6,8 @@
 
 /*! Constructor for the base objects, which are parents of the other derived types.
  *  Sets the object with a random radius. */
-BaseObject::BaseObject(char type, int speedRating){
+BaseObject::BaseObject(Environment* env, char type, int speedRating)
+    : env(env){
 
     setType(type);
     setSpeed(speedRating);
@@ -16,7 +17,8 @@ BaseObject::BaseObject(char type, int speedRating){
 }
 
 /*! Constructor for base objects, which are parents of other derived types. */
-BaseObject::BaseObject(char type, int speedRating, int sizeRating){
+BaseObject::BaseObject(Environment* env, char type, int speedRating, int sizeRating)
+    : env(env){
 
     setType(type);
     setSpeed(speedRating);
@@ -50,11 +52,8 @@ std::pair<int,int> BaseObject::getColors() const{
     return colors;
 }
 
-/*! Defining the static env member variable */
-Environment* BaseObject::env;
-
-/*! Method which returns a pointer to the static environment member variable */
-Environment* BaseObject::getEnv() {
+/*! Method which returns a pointer to the environment the object resides in */
+Environment* BaseObject::getEnv() const{
     return env;
 }
 
@@ -87,7 +86,7 @@ void BaseObject::setRadius(int sizeRating){
 /*! Method which computes a random size rating and sets the object radius accordingly */
 void BaseObject::setRandomRadius(){
 
-    setRadius( (rand() % 100) + 1 );
+    setRadius( env->getRandom().nextInt( 100 ) + 1 );
 
 }
 
@@ -22,19 +22,21 @@ class BaseObject{
     public:
 
         /*! Parent constructor for all objects
+         * \param env The environment which the object resides in
          * \param type A descriptor for the type of object inherting from the base class
          * \param speedRating An integer control for the object's relative speed 
         */ 
-        BaseObject(char type, int speedRating);
+        BaseObject(Environment* env, char type, int speedRating);
         
         /*! Parent constructor for all objects
+         * \param env The environment which the object resides in
          * \param type A descriptor for the type of object inherting from the base class
          * \param speedRating An integer control for the object's relative speed
          * \param sizeRating An integer control for the object's relative size 
         */ 
-        BaseObject(char type, int speedRating, int sizeRating);
+        BaseObject(Environment* env, char type, int speedRating, int sizeRating);
         
-        ~BaseObject();
+        virtual ~BaseObject();
 
         /*! Method which returns the object's unique ID number */
         int getID() const;
@@ -51,8 +53,8 @@ class BaseObject{
         /*! Method which returns a tuple containing primary and secondary color information for the object */
         std::pair<int,int> getColors() const;
         
-        /*! Method which returns a static pointer to the environment which objects reside in */
-        static Environment* getEnv();
+        /*! Method which returns a pointer to the environment which the object resides in */
+        Environment* getEnv() const;
 
         /*! Method which sets the id of the object
          * \param id The id number to assign to the object */
@@ -95,7 +97,7 @@ class BaseObject{
     protected:
     
         /* The environment which the object resides in */
-        static Environment* env;
+        Environment* env;
         
         /* Unique data pertaining to the object */
         int id;
@@ -7,60 +7,138 @@
 #include "Obstacle.hpp"
 #include "Target.hpp"
 #include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
 
-/*! Constructor for Environment takes two arguments, the width and height of the environment */
-Environment::Environment(const int width, const int height, const int scaleFactor){
+const int Environment::OVERLAP_BLOCK_SIZE;
+
+/*! Constructor for Environment takes the width and height of the environment, and creates two robots,
+ *  two targets, and six obstacles, always from the same seed */
+Environment::Environment(const int width, const int height, const int scaleFactor)
+    : Environment(width, height, scaleFactor, 2, 2, 6, 1){
+}
+
+/*! Constructor for Environment which creates the given numbers of robots, targets, and obstacles */
+Environment::Environment(const int width, const int height, const int scaleFactor,
+                         const int numRobots, const int numTargets, const int numObstacles, const uint64_t seed)
+    : rng(seed){
 
     this->width = width*scaleFactor;
     this->height = height*scaleFactor;
 
+    gridIsStale = true;
+    maxRadius = 0;
+    pool = new ThreadPool(1);
+    recorder = 0;
+
     /*! Constructing walls with given environment dimensions */
     walls = new Walls(this->width,this->height);
 
-    /*! Setting the numbers of robots, targets, and obstacles in the env */
-    const int numRobots = 2;
-    const int numTargets = 2;
-    const int numObstacles = 6;
+    /*! Creating the obstacles, targets, and robots, then placing them all at once */
+    std::vector<BaseObject*> newObjects;
+    for(int i = 0; i < numObstacles; i++){
+        newObjects.push_back( new Obstacle(this,0) );
+    }
+    for(int i = 0; i < numTargets; i++){
+        newObjects.push_back( new Target(this,35,25) );
+    }
+    for(int i = 0; i < numRobots; i++){
+        newObjects.push_back( new Robot(this,50,30) );
+    }
+
+    const std::vector<int> ids = registerObjects( newObjects );
 
+    int numPlaced = 0;
     std::vector<int> openTargetIDs;
-    int id;
-
-    /*! Creating and registering the obstacles */
-    for(int i = 0; i < numObstacles; i++){
+    for(int i = 0; i < static_cast<int>( ids.size() ); i++){
 
-        Obstacle* obstacle = new Obstacle(0);
-        id = registerObject( obstacle );
-        obstacle -> setColors(0,0);
-    }
+        const int id = ids[i];
+        if( id < 0 ){
+            continue;
+        }
+        numPlaced++;
 
-    /*! Creating and registering the targets */
-    for(int i = 0; i < numTargets; i++){
+        BaseObject* objPtr = getObject( id );
+        switch( objPtr->getType() ){
 
-        Target* target = new Target(35,25);
-        id = registerObject( target );
-        target -> setColors(id,id); 
-        openTargetIDs.push_back( id );
-    }
+            /*! Obstacles are colored the same */
+            case 'o':
+                objPtr -> setColors(0,0);
+                break;
 
+            /*! Each target gets its own color */
+            case 't':
+                objPtr -> setColors(id,id);
+                openTargetIDs.push_back( id );
+                break;
 
-    /*! Creating and registering the robots */
-    for(int i = 0; i < numRobots; i++){
-    
-        Robot* robot = new Robot(50,30);
-        id = registerObject( robot );
-        robot = dynamic_cast<Robot*>( getObject( id ) );
-        if( openTargetIDs.size() > 0 ){
-            robot -> pairWithTarget( openTargetIDs.back() );
-            robot -> setColors(1, robot->getPairedTargetID() ); 
-            openTargetIDs.pop_back();
+            /*! Robots are paired with the targets while targets remain */
+            case 'r':{
+                Robot* robot = dynamic_cast<Robot*>( objPtr );
+                if( openTargetIDs.size() > 0 ){
+                    robot -> pairWithTarget( openTargetIDs.back() );
+                    robot -> setColors(1, robot->getPairedTargetID() );
+                    openTargetIDs.pop_back();
+                }
+                break;
+            }
         }
     }
 
+    if( numPlaced < static_cast<int>( ids.size() ) ){
+        std::cout << "Only " << numPlaced << " of " << ids.size() << " objects fit in the environment without "
+                  << "overlapping.  The others were left out.\n";
+    }
+
 }
 
 
 /*! Destructor for the Environment */
 Environment::~Environment(){
+
+    for(int i = 0; i < store.size(); i++){
+        delete store.objects[i];
+    }
+    delete walls;
+    delete pool;
+    delete recorder;
+}
+
+/*! Replaces the thread pool with one of the given size */
+void Environment::setNumThreads( int numThreads ){
+
+    delete pool;
+    pool = new ThreadPool( numThreads );
+}
+
+/*! Returns the number of threads in the pool */
+int Environment::getNumThreads() const{
+    return pool -> getNumThreads();
+}
+
+/*! Starts a replay log whose first frame is the current state */
+void Environment::startRecording( const char* path, int keyframeInterval ){
+
+    delete recorder;
+    recorder = new ReplayWriter( path, width, height, keyframeInterval );
+    recorder -> recordFrame( store, 0 );
+}
+
+/*! Writes out and closes the replay log */
+void Environment::stopRecording(){
+
+    delete recorder;
+    recorder = 0;
+}
+
+Random& Environment::getRandom(){
+    return rng;
+}
+
+/*! Method which returns a generator for a separate stream of the seed. Stream 0 belongs to the environment itself. */
+Random Environment::getRandomStream( uint64_t stream ) const{
+    return Random( rng.getSeed(), stream + 1 );
 }
 
 /*! Returns the width of the Environment */
@@ -81,178 +159,176 @@ Walls* Environment::getWalls() const{
 /*! Returns the type of a particular object.  Objects are stored in some hidden
  *  data structure.  This method accesses the objects by index in that data structure */
 char Environment::getObjectType(const int index) const{
-
-    ObjectData* objDataPtr = ( objects.at(index) ).second;
-    return objDataPtr->getType(); 
+    return store.types.at(index);
 }
 
 /*! Returns the position of a particular object(X,Y).  Objects are stored in some hidden
  *  data structure.  This method accesses the objects by index in that data structure */
 std::pair<int,int> Environment::getObjectPosition(const int index) const{
-
-    ObjectData* objDataPtr = ( objects.at(index) ).second;
-    const int x = objDataPtr->getXPosition();
-    const int y = objDataPtr->getYPosition();
-
-    return std::make_pair( x , y );
+    return std::make_pair( store.xs.at(index) , store.ys.at(index) );
 }
 
 /*! Returns the angle of orientation of a particular object.  Objects are stored in some hidden
  *  data structure.  This method accesses the objects by index in that data structure */
 int Environment::getObjectOrientation(const int index) const{
-
-    ObjectData* objDataPtr = ( objects.at(index) ).second;
-    return objDataPtr->getOrientation();
+    return store.orientations.at(index);
 }
 
 /*! Returns the radius of a particular object.  Objects are stored in some hidden
  *  data structure.  This method accesses the objects by index in that data structure */
 int Environment::getObjectRadius(const int index) const{
-    
-    ObjectData* objDataPtr = ( objects.at(index) ).second;
-    return objDataPtr->getRadius();
+    return store.radii.at(index);
 }
 /*! Returns the color  of a particular object.  Objects are stored in first 
  *  data structure.  This method accesses the objects by index in that data structure */
 std::pair<int,int> Environment::getObjectColors(const int index) const{
-
-    BaseObject* objPtr = ( objects.at(index) ).first;
-    return objPtr->getColors();
+    return store.objects.at(index) -> getColors();
 }
 
 /*! Returns the obstacle collision status of a particular object.  Objects are stored in some hidden
  *  data structure.  This method accesses the objects by index in that data structure */
 bool Environment::getObjectObstacleCollisionStatus(const int index) const{
-
-    ObjectData* objDataPtr = ( objects.at(index) ).second;
-    return objDataPtr -> getObstacleCollisionStatus();
+    return store.obstacleCollisions.at(index);
 }
 
 
 /*! Returns the number of objects registered with the environment */
 int Environment::getNumObjects() const{
-    return objects.size();
+    return store.size();
+}
+
+/*! Returns true if the ID belongs to an object currently registered with the environment */
+bool Environment::hasObject( int objectID ) const{
+    return getObjectIndex( objectID ) >= 0;
 }
 
 
 
-/*! Registers an object with the environment.  A pointer to the object is passed to this function
- *  An internal data structure is set up to store information about that object.  A pair of pointers
- *  movement pair.  One pointer is to the object itself, the other pointer is to the object's data.
+/*! Registers an object with the environment.  A pointer to the object is passed to this function.
+ *  The object is placed at a random free spot, and its state is added to the object store, which hands
+ *  out the object's ID.
  */
 int Environment::registerObject( BaseObject* objPtr ){
 
-    // IDs start as 4 so that in future implementation each wall will refer to 0, 1, 2, and 3.
-    static int newID = 4;
+    return registerObjects( std::vector<BaseObject*>( 1, objPtr ) )[0];
 
-    objPtr->setID(newID);
-    const char type = objPtr->getType();
-    const int radius = objPtr->getRadius();
-    ObjectData* objDataPtr = new ObjectData( newID, type, radius );
+}
 
-    // If the object is a target then it's orientation is initialized at random
-    if( type == 't' ){    
-        objDataPtr -> setOrientation( rand() % 360 );
-    }
-    else{
-        objDataPtr -> setOrientation( 0 );
+
+/*! Registers several objects with the environment.  Free spots are found for all of them first, then their
+ *  states are added to the object store in the order given.
+ */
+std::vector<int> Environment::registerObjects( const std::vector<BaseObject*>& objPtrs ){
+
+    std::vector<int> radii( objPtrs.size() );
+    for(int i = 0; i < static_cast<int>( objPtrs.size() ); i++){
+        radii[i] = objPtrs[i]->getRadius();
     }
 
-    newID++;
+    std::vector< std::pair<int,int> > positions;
+    findFreePositions( radii, positions );
 
-    // Storing the data record in the vector of objects
-    objects.push_back( std::make_pair ( objPtr , objDataPtr ) );
+    std::vector<int> ids( objPtrs.size(), -1 );
+    for(int i = 0; i < static_cast<int>( objPtrs.size() ); i++){
 
-    return newID - 1;
+        // Objects without a free spot are not registered
+        if( positions[i].first < 0 ){
+            delete objPtrs[i];
+            continue;
+        }
+
+        // If the object is a target then it's orientation is initialized at random
+        const char type = objPtrs[i]->getType();
+        int degrees = 0;
+        if( type == 't' ){
+            degrees = rng.nextInt( 360 );
+        }
+
+        // Storing the object's state in the store
+        ids[i] = store.insert( objPtrs[i], type, positions[i].first, positions[i].second, degrees, radii[i] );
+        objPtrs[i]->setID( ids[i] );
+    }
+    gridIsStale = true;
+
+    return ids;
 
 }
 
 
-/*! Update situation with the environment.  A pointer to the environment is setting to this function
- *  An internal data structure is based on the amount of time that passed since the last update.  A pair of pointers
- *  the movement pair. According to type. looping over all object to move and to update position.
+/*! Update situation with the environment.  Each update runs in phases. The sense phase only reads positions and
+ *  writes each object's own flags, and the integrate phase only reads each object's own state and writes the back
+ *  buffers of the store, so both phases are split across the thread pool and give the same result for any number
+ *  of threads. The objects of each type sit next to each other in the store, so every phase loops over the range of
+ *  the types it concerns and calls their methods without checking types.
 */
-//TODO: Implement the update method which updates all the object positions
 void Environment::update( int elapsedTime ){
 
-    Robot* robotPtr;
-    Target* targetPtr;
-    ObjectData* objDataPtr;
-    std::pair<int,int> movementPair;
-
-    // Looping over all objects so they may perform sensor scans
-    for(ObjVectorPair::iterator it = objects.begin(); it != objects.end(); ++it){
-
-        char type = ((*it).first) -> getType();
+    // The grid is rebuilt up front, so that touch queries from several threads only read it
+    if( gridIsStale ){
+        rebuildGrid();
+    }
 
-        switch( type ){
-            case 'r':
-                robotPtr = dynamic_cast<Robot*>( (*it).first );
-                robotPtr -> sensorScans();
-                break;
-            case 't':
-                targetPtr = dynamic_cast<Target*>( (*it).first );
-                targetPtr -> sensorScans();
-                break;
-            case 'o':
-            default:
-                break;
+    // Sense phase: the robots and targets perform sensor scans
+    pool -> parallelFor( store.begin( ObjectStore::ROBOTS ), store.end( ObjectStore::ROBOTS ), [this]( int begin, int end ){
+        for(int i = begin; i < end; i++){
+            static_cast<Robot*>( store.objects[i] ) -> sensorScans();
         }
-    }
+    });
+    pool -> parallelFor( store.begin( ObjectStore::TARGETS ), store.end( ObjectStore::TARGETS ), [this]( int begin, int end ){
+        for(int i = begin; i < end; i++){
+            static_cast<Target*>( store.objects[i] ) -> sensorScans();
+        }
+    });
 
     // Creating a vector to house objects marked to be deleted
     std::vector<int> objsToDelete; 
 
     // Deleting robot-target pairs that have collided
-    for(ObjVectorPair::iterator it = objects.begin(); it != objects.end(); ++it){
-    
-        char type = ((*it).first) -> getType();
-        if( type == 'r' ){
-            robotPtr = dynamic_cast<Robot*>( (*it).first );
+    for(int i = store.begin( ObjectStore::ROBOTS ); i < store.end( ObjectStore::ROBOTS ); i++){
 
-            if( robotPtr -> getCollideMyTarget() ){
+        Robot* robotPtr = static_cast<Robot*>( store.objects[i] );
+        if( robotPtr -> getCollideMyTarget() ){
 
-                objsToDelete.push_back( robotPtr -> getID() );
-                objsToDelete.push_back( robotPtr -> getPairedTargetID() );
-            }
+            objsToDelete.push_back( robotPtr -> getID() );
+            objsToDelete.push_back( robotPtr -> getPairedTargetID() );
         }
     }
 
-    // Iterating through vector of marked objs and erasing them
+    // Iterating through vector of marked objs and deleting them
     for(int i = 0; i < static_cast<int>( objsToDelete.size() ); i++){
-
-        int objID = objsToDelete.at(i);
-        int index = getObjectIndex( objID );
-        objects.erase( objects.begin() + index );
+        deleteObject( objsToDelete.at(i) );
     }
         
 
-    // Iterating through the objects and moving them based on elapsedTime
-    for(ObjVectorPair::iterator it = objects.begin(); it != objects.end(); ++it){
-
-        char type = ((*it).first) -> getType();
-        objDataPtr = (*it).second;
-
-        switch( type ){
-            case 'r':
-                robotPtr = dynamic_cast<Robot*>( (*it).first );
-                movementPair = robotPtr -> move( elapsedTime );
-                break;
-
-            case 't':
-                targetPtr = dynamic_cast<Target*>( (*it).first );
-                movementPair = targetPtr -> move( elapsedTime );
-                break;
-
-            case 'o':
-            default:
-                break;
+    // Integrate phase: moving the objects based on elapsedTime into the back buffers, then making them current
+    store.beginIntegration();
+    pool -> parallelFor( store.begin( ObjectStore::OBSTACLES ), store.end( ObjectStore::OBSTACLES ), [this, elapsedTime]( int begin, int end ){
+        for(int i = begin; i < end; i++){
+            std::pair<int,int> movementPair = static_cast<Obstacle*>( store.objects[i] ) -> move( elapsedTime );
+            store.integrate( i, movementPair.first, movementPair.second );
+        }
+    });
+    pool -> parallelFor( store.begin( ObjectStore::TARGETS ), store.end( ObjectStore::TARGETS ), [this, elapsedTime]( int begin, int end ){
+        for(int i = begin; i < end; i++){
+            std::pair<int,int> movementPair = static_cast<Target*>( store.objects[i] ) -> move( elapsedTime );
+            store.integrate( i, movementPair.first, movementPair.second );
         }
+    });
+    pool -> parallelFor( store.begin( ObjectStore::ROBOTS ), store.end( ObjectStore::ROBOTS ), [this, elapsedTime]( int begin, int end ){
+        for(int i = begin; i < end; i++){
+            std::pair<int,int> movementPair = static_cast<Robot*>( store.objects[i] ) -> move( elapsedTime );
+            store.integrate( i, movementPair.first, movementPair.second );
+        }
+    });
+    store.swapBuffers();
 
-        objDataPtr -> rotate( movementPair.first );
-        objDataPtr -> translate( movementPair.second );
+    // Every object may have moved, so the grid is rebuilt before the next collision query
+    gridIsStale = true;
 
-    }   
+    // Appending the new state to the replay log
+    if( recorder ){
+        recorder -> recordFrame( store, elapsedTime );
+    }
 
 }
 
@@ -266,34 +342,71 @@ typedef std::vector< std::pair<int,char> > CollideVectorPair;
 
 CollideVectorPair Environment::touchSensorReading( int objID ){
    
-    ObjectData* objDataPtr = getObjectData( objID );
-    objDataPtr -> setObstacleCollisionStatus( false );
+    const int index = getObjectIndex( objID );
+    if( index < 0 ){
+        std::cout << "No ID match.  Object not found.\n";
+        exit(1);
+    }
+    store.obstacleCollisions[index] = false;
               
     /*! Locally storing the position and radius into about the object */
-    const int typeObj = objDataPtr -> getType();
-    const int xObj = objDataPtr -> getXPosition();
-    const int yObj = objDataPtr -> getYPosition();
-    const int rObj = objDataPtr -> getRadius();
+    const int typeObj = store.types[index];
+    const int xObj = store.xs[index];
+    const int yObj = store.ys[index];
+    const int rObj = store.radii[index];
 
     CollideVectorPair collidingObjs;
 
-    /*! Iterating through all objects and comparing their data to the original object */
-    for(ObjVectorPair::iterator it = objects.begin(); it != objects.end(); ++it){
-        
-        const int otherID = (*it).second -> getID();
-        const int typeOther = (*it).second -> getType();
-        const int xOther = (*it).second -> getXPosition();
-        const int yOther = (*it).second -> getYPosition();
-        const int rOther = (*it).second -> getRadius();
+    if( gridIsStale ){
+        rebuildGrid();
+    }
+
+    /*! Any object overlapping this one has its center within rObj + maxRadius, so only the cells
+     *  covering that square need to be searched */
+    const int reach = rObj + maxRadius;
+    std::vector<int> nearbyIndices;
+    grid.query( xObj - reach, yObj - reach, xObj + reach, yObj + reach, nearbyIndices );
+
+    /*! Gathering the nearby objects into blocks and testing each block against the original object at once */
+    int blockXs[OVERLAP_BLOCK_SIZE];
+    int blockYs[OVERLAP_BLOCK_SIZE];
+    int blockRadii[OVERLAP_BLOCK_SIZE];
+    char overlaps[OVERLAP_BLOCK_SIZE];
+
+    const int numNearby = nearbyIndices.size();
+    for(int blockStart = 0; blockStart < numNearby; blockStart += OVERLAP_BLOCK_SIZE){
+
+        const int blockCount = std::min( OVERLAP_BLOCK_SIZE, numNearby - blockStart );
+        for(int i = 0; i < blockCount; i++){
+            const int other = nearbyIndices[blockStart + i];
+            blockXs[i] = store.xs[other];
+            blockYs[i] = store.ys[other];
+            blockRadii[i] = store.radii[other];
+        }
+
+        circlesOverlap( xObj, yObj, rObj, blockXs, blockYs, blockRadii, blockCount, overlaps );
+
+        /*! Recording the overlapping objects other than the original object. Most candidates do not overlap, so
+         *  their IDs and types are not looked up */
+        for(int i = 0; i < blockCount; i++){
+
+            if( !overlaps[i] ){
+                continue;
+            }
+
+            const int other = nearbyIndices[blockStart + i];
+            const int otherID = store.ids[other];
+            const int typeOther = store.types[other];
 
-        if( ( objID != otherID ) && circlesOverlap( xObj, yObj, rObj, xOther, yOther, rOther ) ){
+            if( objID != otherID ){
 
-            collidingObjs.push_back( std::make_pair( otherID , typeOther ) );
+                collidingObjs.push_back( std::make_pair( otherID , typeOther ) );
 
-            if( typeObj == 'r' && typeOther == 'o' ){
-                objDataPtr -> setObstacleCollisionStatus( true );
+                if( typeObj == 'r' && typeOther == 'o' ){
+                    store.obstacleCollisions[index] = true;
+                }
             }
-        }  
+        }
     }
 
     /*! Wall attributes are obtained */
@@ -324,20 +437,22 @@ CollideVectorPair Environment::touchSensorReading( int objID ){
 */
 std::pair<int,int> Environment::homingSensorReading( int robotID ){
 
-    Robot* robotPtr = dynamic_cast<Robot*>( getObject( robotID ) );
-    ObjectData* robotDataPtr = getObjectData( robotID );
-
-    int targetID = robotPtr -> getPairedTargetID();
-    ObjectData* targetDataPtr = getObjectData( targetID );
+    Robot* robotPtr = static_cast<Robot*>( getObject( robotID ) );
+    const int robot = getObjectIndex( robotID );
+    const int target = getObjectIndex( robotPtr -> getPairedTargetID() );
+    if( target < 0 ){
+        std::cout << "No ID match.  Object not found.\n";
+        exit(1);
+    }
     
-    int xRobot = robotDataPtr -> getXPosition();
-    int yRobot = robotDataPtr -> getYPosition();
+    int xRobot = store.xs[robot];
+    int yRobot = store.ys[robot];
 
-    int xTarget = targetDataPtr -> getXPosition();
-    int yTarget = targetDataPtr -> getYPosition();
+    int xTarget = store.xs[target];
+    int yTarget = store.ys[target];
 
     int theta = (57.2957795*atan2( yTarget - yRobot , xTarget - xRobot ));
-    int targetAngleOffset = theta - robotDataPtr -> getOrientation();
+    int targetAngleOffset = theta - store.orientations[robot];
     int distToTarget = sqrt( pow( ( yTarget - yRobot ) , 2) + pow( ( xTarget - xRobot ) , 2) );   
 
     return std::make_pair( targetAngleOffset , distToTarget );
@@ -349,11 +464,9 @@ std::pair<int,int> Environment::homingSensorReading( int robotID ){
  *  data structure.  This method accesses the objects ID in that data structure */
 BaseObject* Environment::getObject( int objectID ){
 
-    for(ObjVectorPair::iterator it = objects.begin(); it != objects.end(); ++it){
-    
-        if( (*it).first -> getID() == objectID ){
-            return (*it).first;
-        }
+    const int index = getObjectIndex( objectID );
+    if( index >= 0 ){
+        return store.objects[index];
     }
     
     std::cout << "No ID match.  Object not found.\n";
@@ -362,189 +475,177 @@ BaseObject* Environment::getObject( int objectID ){
 }
 
 /*! Method returns the index in the data structure in which an object with the given ID resides */
-int Environment::getObjectIndex( int objectID ){
-
-    int index = -1;
-
-    for(int i = 0; i < static_cast<int>( objects.size() ); i++){
-        if( ( (objects.at(i)).first -> getID() ) == objectID){
-            index = i;
-        }
-    }
-    return index; 
+int Environment::getObjectIndex( int objectID ) const{
+    return store.indexOf( objectID );
 }
 
+/*! Method which deletes an object and removes its state from the store */
+void Environment::deleteObject( int objectID ){
 
-/*! Returns a pointer to the object's data.  Objects are stored in some hidden
- *  data structure.  This method accesses the objects ID in that
- *  hidden data structure */
-Environment::ObjectData* Environment::getObjectData( int objectID ){
-
-    for(ObjVectorPair::iterator it = objects.begin(); it != objects.end(); ++it){
-
-        if( (*it).first -> getID() == objectID ){
-            return (*it).second;
-        }
+    const int index = getObjectIndex( objectID );
+    if( index < 0 ){
+        return;
     }
 
-    std::cout << "No ID match.  Object not found.\n";
-    exit(1);
-}
-
-
-/*! Method which returns true if two circles are overlapping */
-bool Environment::circlesOverlap(int x1, int y1, int r1, int x2, int y2, int r2) {
-
-    return ( sqrt(pow(x1 - x2, 2) + pow(y1 - y2, 2)) - ( r1 + r2 ) ) <= 0; 
+    delete store.objects[index];
+    store.erase( objectID );
+    gridIsStale = true;
 }
 
 
-////////////////////////////  INNER CLASS METHODS ///////////////////////////////
+/*! Method which buckets every object into the grid by its current position. The cells are made as wide
+ *  as the largest object, so a touch query only has to search a few cells around the querying object */
+void Environment::rebuildGrid(){
 
-/*! Setting getter and setter about the Evicorment Class */
-Environment::ObjectData::ObjectData(int id, char type, int radius){
-    setID(id);
-    setType(type);
-    setRadius(radius);
-    setRandomPosition();
-}
-
-/*! Destructor */
-Environment::ObjectData::~ObjectData(){
-}
-
-/*! Returns the current x position of the Object in pixels. */
-int Environment::ObjectData::getXPosition() const {
-    return x;
-}
+    maxRadius = 0;
+    for(int i = 0; i < store.size(); i++){
+        maxRadius = std::max( maxRadius, store.radii[i] );
+    }
 
-/*! Returns the current y position of the Object in pixels. */                
-int Environment::ObjectData::getYPosition() const {
-    return y;
-}
+    grid.reset( width, height, 2*maxRadius );
+    for(int i = 0; i < store.size(); i++){
+        grid.insert( i, store.xs[i], store.ys[i] );
+    }
 
-/*! Returns the current orientation of the Object in degrees. */           
-int Environment::ObjectData::getOrientation() const {
-    return degrees;
+    gridIsStale = false;
 }
 
-/*! Returns the current radius of the Object in pixels. */
-int Environment::ObjectData::getRadius() const {
-    return radius;
-}
 
-/*! Returns the current ID of the Object in ID. */
-int Environment::ObjectData::getID() const {
-    return id;
-}
+/*! Method which returns true if two circles are overlapping. The squared distance between the centers is compared
+ *  with the squared sum of the radii, which avoids the square root. Offsets larger than the sum of the radii are
+ *  clamped to just past it, which keeps the answer and bounds the squares, so the 64-bit sums cannot overflow for
+ *  any positions as long as each radius is below 2^30. */
+bool Environment::circlesOverlap(int x1, int y1, int r1, int x2, int y2, int r2) {
 
-/*! Finding collisions between object and obstacle. 
-Returns true if the Object is colliding with object or obstacle, 
-returns false otherwise.
-*/
-bool Environment::ObjectData::getObstacleCollisionStatus() const {
-    return isCollidingWithObstacle;
-}
+    const int64_t reach = static_cast<int64_t>( r1 ) + r2;
+    const int64_t dx = std::min( std::abs( static_cast<int64_t>( x1 ) - x2 ), reach + 1 );
+    const int64_t dy = std::min( std::abs( static_cast<int64_t>( y1 ) - y2 ), reach + 1 );
 
-/*! Returns the type of the object. */
-char Environment::ObjectData::getType() const {
-    return type;
+    return dx*dx + dy*dy <= reach*reach;
 }
 
 
-/*! Sets object position based on input x and y */
-void Environment::ObjectData::setPosition(int x, int y) {
-    this->x = x;
-    this->y = y;
-}
+/*! Method which checks a circle against a block of circles. Without AVX-512 the vector units have no 64-bit
+ *  multiply, absolute value, or comparison, so the offsets are taken in 32 bits, their magnitudes are squared by
+ *  a widening 32 by 32 bit multiply, and the comparison is made through the sign bit of the squared distance
+ *  less the squared sum of the radii. The clamping of the single test is left out for the same reason, so the
+ *  offsets between the centers and the sums of the radii must fit in an int, as they do for any two objects
+ *  inside the walls. The squared distance is then below 2^63 and the squared reach below 2^62. */
+void Environment::circlesOverlap(int x, int y, int r, const int* xs, const int* ys, const int* radii,
+                                 int count, char* overlaps) {
 
+    for(int i = 0; i < count; i++){
 
-/*! Sets object orientation */
-void Environment::ObjectData::setOrientation(int degrees) {
-    this->degrees = ( (degrees % 360) + 360 ) % 360;
-}
+        // Offsets wrap around in unsigned arithmetic, and are exact once read back as ints
+        const uint32_t dx = static_cast<uint32_t>( x ) - static_cast<uint32_t>( xs[i] );
+        const uint32_t dy = static_cast<uint32_t>( y ) - static_cast<uint32_t>( ys[i] );
+        const uint32_t signX = static_cast<uint32_t>( static_cast<int32_t>( dx ) >> 31 );
+        const uint32_t signY = static_cast<uint32_t>( static_cast<int32_t>( dy ) >> 31 );
+        const uint32_t absX = ( dx ^ signX ) - signX;
+        const uint32_t absY = ( dy ^ signY ) - signY;
+        const uint32_t reach = static_cast<uint32_t>( r ) + static_cast<uint32_t>( radii[i] );
 
-/*! Sets the object radius */
-void Environment::ObjectData::setRadius(int radius) {
-    this->radius = radius;
+        // Negative exactly when the squared distance is at most the squared reach
+        const uint64_t excess = static_cast<uint64_t>( absX ) * absX + static_cast<uint64_t>( absY ) * absY -
+                                static_cast<uint64_t>( reach ) * reach - 1;
+        overlaps[i] = excess >> 63;
+    }
 }
 
-/*! Sets the ID of the Object.*/ 
-void Environment::ObjectData::setID(int id) {
-    this->id = id;
-}
 
-/*! Method which updates the collision status of an object with an obstacle */
-void Environment::ObjectData::setObstacleCollisionStatus(bool status) {
-    isCollidingWithObstacle = status;
-}
+/*! Method which places new objects by dart throwing: random spots are tried until one does not overlap any
+ *  object placed so far. The registered objects and the new objects placed so far are kept in a grid with
+ *  cells as wide as the largest object, so each try only tests the objects in nearby cells. The largest
+ *  objects are placed first, since they are the hardest to fit once space runs out. Once an object finds no
+ *  spot, the enclosure is taken to be full for objects of its size, and the rest of that size are skipped. */
+int Environment::findFreePositions( const std::vector<int>& radii, std::vector< std::pair<int,int> >& positions ){
 
-/*! Sets the object type */
-void Environment::ObjectData::setType(char type) {
-    this->type = type;
-}
+    const int numNew = radii.size();
+    const int numOld = store.size();
+    positions.assign( numNew, std::make_pair( -1, -1 ) );
 
-/*! Rotates the object by a given amount */
-void Environment::ObjectData::rotate( int rotateDegrees ){
-    setOrientation( degrees + rotateDegrees );
-}
+    /*! Computing the workable area */
+    const int thickness = walls->getThickness();
+    const int enclosureWidth = ( walls->getWidth() - 2*thickness );
+    const int enclosureHeight = ( walls->getHeight() - 2*thickness );
+
+    /*! Gathering every circle to avoid into one list, the registered objects first */
+    std::vector<int> xs( store.xs.begin(), store.xs.end() );
+    std::vector<int> ys( store.ys.begin(), store.ys.end() );
+    std::vector<int> rs( store.radii.begin(), store.radii.end() );
+    xs.reserve( numOld + numNew );
+    ys.reserve( numOld + numNew );
+    rs.reserve( numOld + numNew );
+
+    int largestRadius = 0;
+    for(int i = 0; i < numOld; i++){
+        largestRadius = std::max( largestRadius, rs[i] );
+    }
+    for(int i = 0; i < numNew; i++){
+        largestRadius = std::max( largestRadius, radii[i] );
+    }
 
-/*! Translates the object a given amount forward */
-void Environment::ObjectData::translate( int moveForward ){
+    SpatialGrid placed;
+    placed.reset( walls->getWidth(), walls->getHeight(), 2*largestRadius );
+    for(int i = 0; i < numOld; i++){
+        placed.insert( i, xs[i], ys[i] );
+    }
 
-    float radians = 0.01745329 * degrees;
-    int xMove = moveForward*cos(radians);
-    int yMove = moveForward*sin(radians);
+    /*! Ordering the new objects from largest to smallest */
+    std::vector<int> order( numNew );
+    for(int i = 0; i < numNew; i++){
+        order[i] = i;
+    }
+    std::stable_sort( order.begin(), order.end(), [&radii]( int a, int b ){ return radii[a] > radii[b]; } );
 
-    setPosition(x + xMove , y + yMove);
+    int numPlaced = 0;
+    int smallestFailedRadius = std::numeric_limits<int>::max();
+    std::vector<int> nearbyIndices;
 
-}
+    for(int k = 0; k < numNew; k++){
 
-/*! Method which sets the object's position in the environment at random */
-void Environment::ObjectData::setRandomPosition(){
+        const int i = order[k];
+        const int radius = radii[i];
 
-    /*! Computing the workable area */
-    const int enclosureWidth = ( walls->getWidth() - 2*walls->getThickness() );
-    const int enclosureHeight = ( walls->getHeight() - 2*walls->getThickness() );
+        /*! Objects wider than the enclosure never fit, nor do objects as large as one which already failed */
+        if( enclosureWidth - 2*radius <= 0 || enclosureHeight - 2*radius <= 0 || radius >= smallestFailedRadius ){
+            continue;
+        }
 
-    /*! Attempting to place the object in the movable area */
-    int numAttempts = 0;
-    bool isTouching;
+        /*! Any object overlapping this one has its center within radius + largestRadius */
+        const int reach = radius + largestRadius;
 
-    do
-    {
-        /*! Assume nothing is touching this object yet */
-        isTouching = false;
-        numAttempts++;
+        for(int attempt = 0; attempt < MAX_PLACEMENT_ATTEMPTS; attempt++){
 
-        /*! Generating random x and y values for the agent to be placed at */
-        x = ( rand() % ( enclosureWidth - 2*radius ) ) + radius + walls->getThickness();
-        y = ( rand() % ( enclosureHeight - 2*radius ) ) + radius + walls->getThickness();
+            /*! Generating random x and y values for the agent to be placed at */
+            const int x = rng.nextInt( enclosureWidth - 2*radius ) + radius + thickness;
+            const int y = rng.nextInt( enclosureHeight - 2*radius ) + radius + thickness;
 
-        /*! Iterating through all the objects in the vector of objects */
-        for(ObjVectorPair::iterator it = objects.begin(); it != objects.end(); ++it){
+            /*! Determining whether the random (x,y) is valid based on nearby objects locations */
+            nearbyIndices.clear();
+            placed.query( x - reach, y - reach, x + reach, y + reach, nearbyIndices );
 
-            int x2 = (*it).second -> getXPosition();
-            int y2 = (*it).second -> getYPosition();
-            int r2 = (*it).second -> getRadius();
+            bool isTouching = false;
+            for(int n = 0; n < static_cast<int>( nearbyIndices.size() ) && !isTouching; n++){
+                const int j = nearbyIndices[n];
+                isTouching = circlesOverlap( x, y, radius, xs[j], ys[j], rs[j] );
+            }
 
-            /*! Determining whether the random (x,y) is valid based on other objects locations */
-            if( circlesOverlap(x, y, radius, x2, y2, r2) ){
-                isTouching = true;
+            if( !isTouching ){
+                positions[i] = std::make_pair( x, y );
+                placed.insert( xs.size(), x, y );
+                xs.push_back( x );
+                ys.push_back( y );
+                rs.push_back( radius );
+                numPlaced++;
+                break;
             }
         }
-        
-      /*! Continue looping and trying new (x,y) positions until a valid one is found */
-    } while ( isTouching && ( numAttempts < 100 ) );
-
-}
-
-//////////////  STATIC VAR DEFINITIONS /////////////////////
-
-int Environment::width;
-int Environment::height;
-
-Walls* Environment::walls;
-std::vector< std::pair<BaseObject* , Environment::ObjectData* > > Environment::objects;
 
+        if( positions[i].first < 0 ){
+            smallestFailedRadius = radius;
+        }
+    }
 
+    return numPlaced;
+}
@@ -13,16 +13,21 @@
 #include <utility>
 #include "BaseObject.hpp"
 #include "Walls.hpp"
+#include "SpatialGrid.hpp"
+#include "ObjectStore.hpp"
+#include "ThreadPool.hpp"
+#include "Random.hpp"
+#include "ReplayWriter.hpp"
 
 class BaseObject; // forward declaration
 
 /** The Environment class contains a container of objects and methods for creating and desetroying them. It also
  *  Has methods for dealing with interactions between different objects.  */  
 class Environment{
-
+        
     public:
     
-        /*! Environment constructor.
+        /*! Environment constructor. The environment is always seeded the same way.
             \param width The width of the environment.
             \param height The height of the environment.
             \param scaleFactor The scaling factor which maps between pixels and distance units
@@ -30,19 +35,69 @@ class Environment{
         Environment(const int width, const int height, const int scaleFactor);
         
         
-        /*! Environment destructor */
+        /*! Environment constructor which sets how many of each object are created.
+            \param width The width of the environment.
+            \param height The height of the environment.
+            \param scaleFactor The scaling factor which maps between pixels and distance units
+            \param numRobots The number of robots, each paired with a target while targets remain.
+            \param numTargets The number of targets.
+            \param numObstacles The number of obstacles.
+            \param seed The seed of the environment's random numbers. Environments with the same seed and
+                        arguments are created identically.
+         */
+        Environment(const int width, const int height, const int scaleFactor,
+                    const int numRobots, const int numTargets, const int numObstacles, const uint64_t seed);
+        
+        
+        /*! Environment destructor. Deletes every object registered with the environment. */
         ~Environment();
+        
+        
+        /*! Environments own their objects, so they are not copied */
+        Environment(const Environment&) = delete;
+        Environment& operator=(const Environment&) = delete;
     
     
+        /*! Sets the number of threads which share the work of each update. The results do not depend on it.
+         *  \param numThreads The number of threads, or 0 for one per hardware thread */
+        void setNumThreads( int numThreads );
+        
+        
+        /*! Returns the number of threads which share the work of each update */
+        int getNumThreads() const;
+        
+        
+        /*! Starts recording the state of every object after each update to a replay log, which a ReplayReader
+         *  can play back. The current state is recorded as frame 0. Any log already being recorded is closed.
+         *  \param path The path of the log file, which is replaced if it exists.
+         *  \param keyframeInterval The number of frames between full copies of the state in the log */
+        void startRecording( const char* path, int keyframeInterval = ReplayWriter::DEFAULT_KEYFRAME_INTERVAL );
+        
+        
+        /*! Stops recording, writing out the rest of the replay log */
+        void stopRecording();
+        
+        
+        /*! Returns the random number generator used to set up the environment and its objects */
+        Random& getRandom();
+        
+        
+        /*! Returns a new generator drawing from a separate stream of the environment's seed. Each thread which
+         *  needs random numbers during an update should draw from its own stream, so the numbers do not depend on
+         *  how the work is split between threads.
+         *  \param stream The stream to draw from, which should differ between callers */
+        Random getRandomStream( uint64_t stream ) const;
+        
+        
         /*! Returns a pointer to the environment's walls for external use */
         Walls* getWalls() const;
         
     /*! Returns the width of the environment */
     int getWidth() const;
-
+        
     /*! Returns the height of the environment */
     int getHeight() const;
-
+        
         /*! Returns the string identifier type of a particular object in the environment, referenced by index.
          *  \param index An index into the container of objects in the environment */
         char getObjectType(const int index) const;
@@ -75,188 +130,144 @@ class Environment{
     
         /*! Returns the number of objects registered with the environment */
         int getNumObjects() const;
+        
+        
+        /*! Checks whether an ID number refers to an object which is still in the environment. IDs of deleted
+         *  objects are never confused with the IDs of objects registered later into the same slot.
+         *  \param objectID The ID number to check */
+        bool hasObject( int objectID ) const;
       
         
-        /*! Registers an object with the environment.  
-         * \param objPtr A pointer to an object which is to be registered with the environment. */
+        /*! Registers an object with the environment, which takes ownership of it.
+         *  The object must have been constructed with a pointer to this environment.
+         * \param objPtr A pointer to an object which is to be registered with the environment.
+         * \return The ID of the object, or -1 if there was no free spot for it, in which case it was deleted. */
         int registerObject( BaseObject* objPtr);
         
         
-        /*! Update the physical state of everything in the environment.
+        /*! Registers many objects with the environment at once, which takes ownership of them. Each object is
+         *  placed at a random spot inside the walls where it overlaps neither the registered objects nor the
+         *  other new objects. Objects for which no such spot is found are deleted instead of being registered.
+         * \param objPtrs Pointers to objects constructed with a pointer to this environment.
+         * \return The ID of each object in the same order, or -1 for each object which was deleted. */
+        std::vector<int> registerObjects( const std::vector<BaseObject*>& objPtrs );
+        
+        
+        /*! Update the physical state of everything in the environment. Sensor scans and movement are each spread
+         *  across the thread pool.
          *  \param elapsedTime The amount of time (in seconds) which has elapsed since the last update */
         void update(int elapsedTime);     
     
     
-        /*! Detects whether a given object in the environment is colliding with any other object in the environment. 
+        /*! Detects whether a given object in the environment is colliding with any other object in the environment.
+            Only objects in the grid cells near the given object are tested. May be called from several threads
+            at once during an update, when the grid is already built.
             \param objID The id number of the object whose collision status is to be determined */
         typedef std::vector< std::pair<int,char> > CollideVectorPair;
         CollideVectorPair touchSensorReading( int objID );
-
+        
     
         /*! Determines the angle and distance an object in the environment must rotate and move by to reach its target
          * \param robotID The id number of the robot in the environment which seeks out targets */
         typedef std::pair<int,int> HomingPair;
         HomingPair homingSensorReading( int robotID );
-
-    private:
-
-        class ObjectData{
-
-            public:
-            
-                /*! Constructor for ObjectData
-                \param id The identification number.
-                \param type The type of object.
-                \param radius The radius of the object. */ 
-                ObjectData(int id, char type, int radius);
-                
-                
-                /*! Destructor */        
-                ~ObjectData();
-                
-                
-                /*! Returns the current x position of the Object in pixels. */
-                int getXPosition() const;
-                
-                
-                /*! Returns the current y position of the Object in pixels. */                
-                int getYPosition() const;
-                
-                
-                /*! Returns the current orientation of the Object in degrees. */           
-                int getOrientation() const;
-                
-                
-                /*! Returns the current radius of the Object in pixels. */
-                int getRadius() const;
-                
-                
-                /*! Returns the current ID of the Object in pixels. */
-                int getID() const;
-              
-              
-                /*! Returns the collision status of an object-obstacle interaction */
-                bool getObstacleCollisionStatus() const;
-                
-                
-                /*! Returns the type specifier of the object */
-                char getType() const;
-                
-                
-                /*! Sets a new (x,y) position of the object
-                    \param x The new x position of the object in pixels.
-                    \param y The new y position of the object in pixels.
-                */
-                void setPosition(int x, int y);
-                
-                
-                /*! Sets a new angle of orientation for the object
-                    \param degrees The new orientation of the object in degrees.
-                */          
-                void setOrientation(int degrees);
-                
-                
-                /*! Changes the radius of the Object.
-                    \param radius The new radius of the object in pixels.  */ 
-                void setRadius(int radius);
-                
-                
-                /*! Sets the ID of the Object.
-                    \param ID The new ID of the object.
-                */ 
-                void setID(int id);
-                
-                
-                /*! Changes the object-obstacle collision status.
-                 *  \param status The new collision status to be set */
-                void setObstacleCollisionStatus(bool status);
-                
-                
-                /*! Changes the type of the object.
-                    \param ID The new type specifier for the object */
-                void setType(char type);
-                
-                
-                /*! Rotate the object by a given amount of degrees.
-                 *  \param degrees The number of degrees by which to rotate the object */
-                void rotate( int degrees );
-                
-                
-                /*! Translates the object across the environment by a given amount in the direction it currently faces.
-                 *  \param moveForward The amount by which to translate the object in its current direction of travel. */
-                void translate( int moveForward );
-
-
-            private:
-            
-                /*! The current x position of the object, in pixels. */
-                int x;
-                
-                 /*! The current y position of the object, in pixels. */
-                int y;
-                
-                /*! The current orientation of the object, in degrees. */
-                int degrees;
-                
-                /*! The current radius of the object, in pixels. */
-                int radius;
-                
-                /*! The identification number of the object */
-                int id;
-                
-                /*! Object-obstacle collision flag */
-                bool isCollidingWithObstacle;
-                
-                /*! Object type specifier */
-                char type;
-                
-                /*! This method places the object at a random collision-free location in the environment */
-                void setRandomPosition();
-
-        }; // end of inner-class ObjectData
         
         
-        /*! A pair which groups an object pointer and associated meta-data into one entity */
-        typedef std::vector< std::pair< BaseObject*, ObjectData* > > ObjVectorPair;
+        /*! Helper function which checks to see whether or not two given circles are in an overlapping state.
+         *  Circles which only touch count as overlapping.
+         * \param x1 The X-position of the first circle.
+         * \param y1 The Y-position of the first circle.
+         * \param r1 The radius of the first circle.
+         * \param x2 The X-position of the second circle.
+         * \param y2 The Y-position of the second circle.
+         * \param r2 The Radius of the second circle. */
+        static bool circlesOverlap(int x1, int y1, int r1, int x2, int y2, int r2);
+        
+        
+        /*! Checks one circle against a block of circles stored as separate arrays, giving the same answers as
+         *  calling circlesOverlap on each as long as the offsets between centers and the sums of radii fit in an
+         *  int. The loop has no branches and only 32-bit products widened to 64 bits, so the compiler can
+         *  vectorize it with SSE2.
+         * \param x The X-position of the circle.
+         * \param y The Y-position of the circle.
+         * \param r The radius of the circle.
+         * \param xs The X-positions of the block of circles.
+         * \param ys The Y-positions of the block of circles.
+         * \param radii The radii of the block of circles.
+         * \param count The number of circles in the block.
+         * \param overlaps Receives 1 for each circle of the block which overlaps the circle, and 0 otherwise. */
+        static void circlesOverlap(int x, int y, int r, const int* xs, const int* ys, const int* radii,
+                                   int count, char* overlaps);
+        
         
-        /*! Collection of all grouped objects & data in the environment */
-        static ObjVectorPair objects;
+        /*! Number of candidate circles which touchSensorReading gathers into each block */
+        static const int OVERLAP_BLOCK_SIZE = 64;
+        
+    private:
+        
+        /*! State of every object in the environment, kept in one array per property and partitioned by type */
+        ObjectStore store;
         
         /*! Walls which form the boundaries of the environment */
-        static Walls* walls;
+        Walls* walls;
         
         /*! Environment width */
-        static int width;
+        int width;
         
         /*! Environment height */
-        static int height;
-
-
+        int height;
+        
+        /*! Uniform grid holding the index of each object, used to find the objects near a given point */
+        SpatialGrid grid;
+        
+        /*! Flag which is true when objects were added, removed, or moved since the grid was last built */
+        bool gridIsStale;
+        
+        /*! The largest radius of any object in the grid */
+        int maxRadius;
+        
+        /*! Threads which run the phases of each update, starting with just the calling thread */
+        ThreadPool* pool;
+        
+        /*! Writer of the replay log, or null when the environment is not being recorded */
+        ReplayWriter* recorder;
+        
+        /*! Random number generator used while setting up objects, drawing from stream 0 of the seed */
+        Random rng;
+        
+        
+        /*! Rebuilds the grid from the current object positions. Cells are as wide as the largest object. */
+        void rebuildGrid();
+        
+        
         /*! Returns a pointer to an object in the environment, referenced by identification number
          *  \param objectID The ID number of the object whose pointer is requested */
         BaseObject* getObject( int objectID );
         
         
-        /*! Returns the index into the environment's object collision which matches a given ID number
-         *  \param objectID The ID number of the object whose index in the object collision is requested */
-        int getObjectIndex( int objectID );
+        /*! Returns the index into the object store which matches a given ID number, in constant time
+         *  \param objectID The ID number of the object whose index in the object collection is requested
+         *  \return The index, or -1 if no object in the environment has the ID */
+        int getObjectIndex( int objectID ) const;
         
         
-        /*! Returns a pointer to assosicated object meta-data, referenced by identification number
-         *  \param objectID The ID number of the object whose meta-data is requested */
-        ObjectData* getObjectData( int objectID );
+        /*! Deletes an object and removes its state from the object store. The deleted ID is no longer found.
+         *  \param objectID The ID number of the object to delete */
+        void deleteObject( int objectID );
+        
+        
+        /*! Number of random spots tried for each new object before giving up on it */
+        static const int MAX_PLACEMENT_ATTEMPTS = 100;
+        
+        
+        /*! Picks random positions for new objects inside the walls, where each overlaps neither a registered
+         *  object nor another new object. Up to MAX_PLACEMENT_ATTEMPTS spots are tried for each object.
+         *  \param radii The radii of the new objects.
+         *  \param positions Receives the position of each new object, or (-1,-1) if no free spot was found.
+         *  \return The number of objects which were placed */
+        int findFreePositions( const std::vector<int>& radii, std::vector< std::pair<int,int> >& positions );
        
        
-        /*! Helper function which checks to see whether or not two given circles are in an overlapping state.
-         * \param x1 The X-position of the first circle.
-         * \param y1 The Y-position of the first circle.
-         * \param r1 The radius of the first circle.
-         * \param x2 The X-position of the second circle.
-         * \param y2 The Y-position of the second circle.
-         * \param r2 The Radius of the second circle. */
-        static bool circlesOverlap(int x1, int y1, int r1, int x2, int y2, int r2);
-
-
 }; // end of class Environment
 
 
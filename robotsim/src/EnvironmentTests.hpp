@@ -3,12 +3,14 @@
 #include "Environment.hpp"
 #include "BaseObject.hpp"
 #include "Walls.hpp"
+#include "Obstacle.hpp"
 
 #include <vector>
 #include <utility>
 #include <iostream>
 #include <ctime>
 #include <cmath>
+#include <chrono>
 
 using namespace std;
 
@@ -45,6 +47,200 @@ public:
        }
 
 
+       void testEnvironmentsAreIndependent(void){
+        Environment* first = new Environment(800,800,400);
+        Environment* second = new Environment(400,400,400,3,3,1,1);
+        //each environment holds only its own objects
+        TS_ASSERT_EQUALS(10,first->getNumObjects());
+        TS_ASSERT_EQUALS(7,second->getNumObjects());
+        //updating one environment leaves the other untouched
+        std::pair<int,int> expected = first->getObjectPosition(0);
+        second->update(33);
+        std::pair<int,int> actual = first->getObjectPosition(0);
+        TS_ASSERT_EQUALS(expected,actual);
+        TS_ASSERT_EQUALS(400*400,second->getWidth());
+        TS_ASSERT_EQUALS(800*400,first->getWidth());
+        delete first;
+        delete second;
+       }
+
+
+       void testObjectIDs(void){
+        Environment* env = new Environment(800,800,400);
+        //the ten default objects take IDs 4 to 13, and IDs 0 to 3 are left for the walls
+        TS_ASSERT(env->hasObject(4));
+        TS_ASSERT(env->hasObject(13));
+        TS_ASSERT(!env->hasObject(1));
+        TS_ASSERT(!env->hasObject(-1));
+        //a newly registered object gets the next ID
+        int id = env->registerObject(new Obstacle(env,0));
+        TS_ASSERT_EQUALS(14,id);
+        TS_ASSERT(env->hasObject(id));
+        TS_ASSERT_EQUALS(11,env->getNumObjects());
+        delete env;
+       }
+
+
+       void testBulkPlacementAvoidsOverlaps(void){
+        Environment* env = new Environment(800,800,1000,0,0,0,3);
+        //far more objects than fit are offered, and those left out are reported with ID -1
+        vector<BaseObject*> objects;
+        for(int i = 0; i < 500; i++){
+            objects.push_back(new Obstacle(env,0));
+        }
+        vector<int> ids = env->registerObjects(objects);
+        TS_ASSERT_EQUALS(500,(int)ids.size());
+        int numPlaced = 0;
+        for(int i = 0; i < (int)ids.size(); i++){
+            if( ids[i] >= 0 ){
+                numPlaced++;
+                TS_ASSERT(env->hasObject(ids[i]));
+            }
+        }
+        TS_ASSERT(numPlaced > 0);
+        TS_ASSERT(numPlaced < 500);
+        TS_ASSERT_EQUALS(numPlaced,env->getNumObjects());
+        //no two placed objects overlap
+        for(int i = 0; i < env->getNumObjects(); i++){
+            for(int j = i + 1; j < env->getNumObjects(); j++){
+                double dx = env->getObjectPosition(i).first - env->getObjectPosition(j).first;
+                double dy = env->getObjectPosition(i).second - env->getObjectPosition(j).second;
+                TS_ASSERT(sqrt(dx*dx + dy*dy) > env->getObjectRadius(i) + env->getObjectRadius(j));
+            }
+        }
+        delete env;
+       }
+
+
+       //the overlap test before the squared distance kernels, through double precision pow and sqrt
+       static bool oldCirclesOverlap(int x1, int y1, int r1, int x2, int y2, int r2){
+        return ( sqrt(pow(x1 - x2, 2) + pow(y1 - y2, 2)) - ( r1 + r2 ) ) <= 0;
+       }
+
+
+       void testOverlapKernelMatchesAndBenchmark(void){
+        //circles spread like objects in an 800 by 800 environment, each tested against a block of nearby candidates
+        const int numCircles = 4096;
+        const int block = Environment::OVERLAP_BLOCK_SIZE;
+        const int rounds = 40;
+        const int repeats = 5;
+        Random random(11);
+        vector<int> xs(numCircles), ys(numCircles), radii(numCircles);
+        for(int i = 0; i < numCircles; i++){
+            xs[i] = random.nextInt(800000);
+            ys[i] = random.nextInt(800000);
+            radii[i] = random.nextInt(60000) + 1;
+        }
+        //edge cases: touching circles and the farthest corners of a large environment
+        xs[0] = 0; ys[0] = 0; radii[0] = 3;
+        xs[1] = 5; ys[1] = 0; radii[1] = 2;
+        xs[2] = 2000000000; ys[2] = 2000000000; radii[2] = 1;
+        vector<char> overlaps(block);
+
+        //the old test was called once per pair by touchSensorReading, so it is not inlined here either
+        bool (*volatile oldTest)(int,int,int,int,int,int) = &oldCirclesOverlap;
+
+        //each way is timed several times in turn, and the fastest time of each is kept
+        long oldCount = 0, singleCount = 0, blockCount = 0;
+        double oldSeconds = 1e9, singleSeconds = 1e9, blockSeconds = 1e9;
+        for(int repeat = 0; repeat < repeats; repeat++){
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for(int round = 0; round < rounds; round++){
+                for(int i = 0; i < numCircles - block; i += 7){
+                    for(int j = i; j < i + block; j++){
+                        oldCount += oldTest(xs[i], ys[i], radii[i], xs[j], ys[j], radii[j]);
+                    }
+                }
+            }
+            oldSeconds = min(oldSeconds, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+
+            //the squared distance test, one candidate at a time
+            start = chrono::steady_clock::now();
+            for(int round = 0; round < rounds; round++){
+                for(int i = 0; i < numCircles - block; i += 7){
+                    for(int j = i; j < i + block; j++){
+                        singleCount += Environment::circlesOverlap(xs[i], ys[i], radii[i], xs[j], ys[j], radii[j]);
+                    }
+                }
+            }
+            singleSeconds = min(singleSeconds, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+
+            //the squared distance test, a block of candidates at a time
+            start = chrono::steady_clock::now();
+            for(int round = 0; round < rounds; round++){
+                for(int i = 0; i < numCircles - block; i += 7){
+                    Environment::circlesOverlap(xs[i], ys[i], radii[i], &xs[i], &ys[i], &radii[i], block, &overlaps[0]);
+                    for(int j = 0; j < block; j++){
+                        blockCount += overlaps[j];
+                    }
+                }
+            }
+            blockSeconds = min(blockSeconds, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+        }
+
+        TS_ASSERT_EQUALS(oldCount,singleCount);
+        TS_ASSERT_EQUALS(oldCount,blockCount);
+        TS_ASSERT(Environment::circlesOverlap(0,0,3,5,0,2));
+        TS_ASSERT(!Environment::circlesOverlap(0,0,3,6,0,2));
+        TS_ASSERT(!Environment::circlesOverlap(-2000000000,-2000000000,1,2000000000,2000000000,1));
+
+        const double tests = double(rounds) * ( ( numCircles - block + 6 ) / 7 ) * block;
+        cout << "\ncircle overlap tests per second: pow and sqrt " << tests / oldSeconds
+             << ", squared distance " << tests / singleSeconds
+             << ", blocks of " << block << " " << tests / blockSeconds
+             << " (" << oldSeconds / blockSeconds << " times pow and sqrt)\n";
+       }
+
+
+       void testSeedRepeatsEnvironment(void){
+        //environments with the same seed are created identically, and a different seed places objects elsewhere
+        Environment* first = new Environment(800,800,1000,5,5,10,42);
+        Environment* second = new Environment(800,800,1000,5,5,10,42);
+        Environment* other = new Environment(800,800,1000,5,5,10,43);
+        TS_ASSERT_EQUALS(first->getNumObjects(),second->getNumObjects());
+        bool differs = false;
+        for(int i = 0; i < first->getNumObjects(); i++){
+            TS_ASSERT_EQUALS(first->getObjectPosition(i),second->getObjectPosition(i));
+            TS_ASSERT_EQUALS(first->getObjectOrientation(i),second->getObjectOrientation(i));
+            TS_ASSERT_EQUALS(first->getObjectRadius(i),second->getObjectRadius(i));
+            if( first->getObjectPosition(i) != other->getObjectPosition(i) ){
+                differs = true;
+            }
+        }
+        TS_ASSERT(differs);
+        //streams of the same seed are repeatable and differ from each other
+        Random stream = first->getRandomStream(3);
+        Random sameStream = second->getRandomStream(3);
+        Random otherStream = first->getRandomStream(4);
+        TS_ASSERT_EQUALS(stream.next(),sameStream.next());
+        TS_ASSERT(sameStream.next() != otherStream.next());
+        delete first;
+        delete second;
+        delete other;
+       }
+
+
+       void testUpdateIsIndependentOfThreadCount(void){
+        //two identical worlds, updated on one and on four threads
+        Environment* serial = new Environment(800,800,1000,30,20,10,5);
+        Environment* parallel = new Environment(800,800,1000,30,20,10,5);
+        parallel->setNumThreads(4);
+        TS_ASSERT_EQUALS(4,parallel->getNumThreads());
+        for(int step = 0; step < 200; step++){
+            serial->update(33);
+            parallel->update(33);
+        }
+        TS_ASSERT_EQUALS(serial->getNumObjects(),parallel->getNumObjects());
+        for(int i = 0; i < serial->getNumObjects(); i++){
+            TS_ASSERT_EQUALS(serial->getObjectPosition(i),parallel->getObjectPosition(i));
+            TS_ASSERT_EQUALS(serial->getObjectOrientation(i),parallel->getObjectOrientation(i));
+        }
+        delete serial;
+        delete parallel;
+       }
+
+
 //TODO
 
 //
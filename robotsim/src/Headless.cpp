@@ -0,0 +1,198 @@
+/**
+ * \author George Brown
+ *
+ * \file  Headless.cpp
+ * \brief Main function for running the simulation without a window. The environment is advanced by a fixed
+ *        simulated time step as fast as possible, so long runs can be simulated offline.
+ *
+ */
+
+#include "Environment.hpp"
+#include "ReplayReader.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/*! Prints the command line options of the headless runner */
+static void printUsage(){
+
+    std::cout << "Usage: gorobot-headless [options]\n"
+              << "  --robots <int>     number of robots (default 2)\n"
+              << "  --targets <int>    number of targets (default 2)\n"
+              << "  --obstacles <int>  number of obstacles (default 6)\n"
+              << "  --steps <int>      number of updates to simulate (default 10000)\n"
+              << "  --dt <int>         simulated milliseconds per update (default 33)\n"
+              << "  --seed <int>       random seed (default 1)\n"
+              << "  --threads <int>    threads sharing each update, 0 for one per hardware thread (default 1)\n"
+              << "  --size <int> <int> environment width and height in pixels (default 800 800)\n"
+              << "  --record <file>    write a replay log of every update\n"
+              << "  --keyframes <int>  updates between full copies of the state in the replay log (default 100)\n"
+              << "  --replay <file>    instead of simulating, print a frame of a replay log\n"
+              << "  --frame <int>      frame of the replay log to print (default the last)\n";
+}
+
+/*! Loads a frame of a replay log and prints the state of every object in it */
+static void printReplayFrame(const char* path, int frame){
+
+    std::chrono::steady_clock::time_point openStart = std::chrono::steady_clock::now();
+    ReplayReader replay( path );
+    std::chrono::steady_clock::time_point seekStart = std::chrono::steady_clock::now();
+
+    if( frame < 0 ){
+        frame = replay.getNumFrames() - 1;
+    }
+    if( !replay.seek( frame ) ){
+        std::cout << "The replay log has frames 0 to " << replay.getNumFrames() - 1 << " only.\n";
+        exit(1);
+    }
+    std::chrono::steady_clock::time_point seekEnd = std::chrono::steady_clock::now();
+
+    std::cout << "Replay log of " << replay.getNumFrames() << " frames with " << replay.getNumKeyframes()
+              << " keyframes, opened in " << std::chrono::duration<double>( seekStart - openStart ).count()
+              << " s\n"
+              << "Frame " << frame << " after an update of " << replay.getElapsedTime() << " ms, loaded in "
+              << std::chrono::duration<double>( seekEnd - seekStart ).count() << " s, has "
+              << replay.getNumObjects() << " objects\n"
+              << "id type x y orientation radius obstacle-collision\n";
+
+    for(int i = 0; i < replay.getNumObjects(); i++){
+        std::cout << replay.getObjectID(i) << " " << replay.getObjectType(i) << " "
+                  << replay.getObjectPosition(i).first << " " << replay.getObjectPosition(i).second << " "
+                  << replay.getObjectOrientation(i) << " " << replay.getObjectRadius(i) << " "
+                  << replay.getObjectObstacleCollisionStatus(i) << "\n";
+    }
+}
+
+/*! Reads a nonnegative integer option value, or exits if it is not one */
+static int readCount(const char* flag, const char* value){
+
+    char* end;
+    const long count = strtol(value, &end, 10);
+    if( *end != '\0' || count < 0 ){
+        std::cout << "Invalid value " << value << " for " << flag << ". A nonnegative integer is expected.\n";
+        exit(1);
+    }
+    return count;
+}
+
+int main(int argc, char* argv[])
+{
+    // Scale factor which maps between pixels and distance units, as in the graphical simulation
+    const int scaleFactor = 1000;
+
+    int numRobots = 2;
+    int numTargets = 2;
+    int numObstacles = 6;
+    int numSteps = 10000;
+    int dt = 33;
+    int seed = 1;
+    int numThreads = 1;
+    int width = 800;
+    int height = 800;
+    const char* recordPath = 0;
+    int keyframeInterval = ReplayWriter::DEFAULT_KEYFRAME_INTERVAL;
+    const char* replayPath = 0;
+    int replayFrame = -1;
+
+    for(int i = 1; i < argc; i++){
+
+        const bool hasValue = ( i + 1 < argc );
+
+        if( strcmp(argv[i], "--robots") == 0 && hasValue ){
+            numRobots = readCount(argv[i], argv[i+1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "--targets") == 0 && hasValue ){
+            numTargets = readCount(argv[i], argv[i+1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "--obstacles") == 0 && hasValue ){
+            numObstacles = readCount(argv[i], argv[i+1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "--steps") == 0 && hasValue ){
+            numSteps = readCount(argv[i], argv[i+1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "--dt") == 0 && hasValue ){
+            dt = readCount(argv[i], argv[i+1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "--seed") == 0 && hasValue ){
+            seed = readCount(argv[i], argv[i+1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "--threads") == 0 && hasValue ){
+            numThreads = readCount(argv[i], argv[i+1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "--record") == 0 && hasValue ){
+            recordPath = argv[i+1];
+            i++;
+        }
+        else if( strcmp(argv[i], "--keyframes") == 0 && hasValue ){
+            keyframeInterval = readCount(argv[i], argv[i+1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "--replay") == 0 && hasValue ){
+            replayPath = argv[i+1];
+            i++;
+        }
+        else if( strcmp(argv[i], "--frame") == 0 && hasValue ){
+            replayFrame = readCount(argv[i], argv[i+1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "--size") == 0 && i + 2 < argc ){
+            width = readCount(argv[i], argv[i+1]);
+            height = readCount(argv[i], argv[i+2]);
+            i += 2;
+        }
+        else{
+            std::cout << "Unknown option " << argv[i] << "\n";
+            printUsage();
+            exit(1);
+        }
+    }
+
+    if( replayPath ){
+        printReplayFrame( replayPath, replayFrame );
+        return 0;
+    }
+
+    if( width < 100 || height < 100 ){
+        std::cout << "The environment must be at least 100 by 100 pixels.\n";
+        exit(1);
+    }
+
+    std::chrono::steady_clock::time_point setupStart = std::chrono::steady_clock::now();
+    Environment* env = new Environment( width, height, scaleFactor, numRobots, numTargets, numObstacles, seed );
+    std::chrono::steady_clock::time_point runStart = std::chrono::steady_clock::now();
+
+    env->setNumThreads( numThreads );
+    if( recordPath ){
+        env->startRecording( recordPath, keyframeInterval );
+    }
+
+    std::cout << "Created " << env->getNumObjects() << " objects in "
+              << std::chrono::duration<double>( runStart - setupStart ).count() << " s, running on "
+              << env->getNumThreads() << " threads\n";
+
+    /*! Advancing the environment by the same simulated time every step, without waiting for the wall clock */
+    for(int step = 0; step < numSteps; step++){
+        env->update( dt );
+    }
+
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - runStart ).count();
+    const double simulatedSeconds = numSteps * ( dt / 1000.0 );
+
+    std::cout << "Simulated " << numSteps << " steps of " << dt << " ms (" << simulatedSeconds << " s) in "
+              << seconds << " s\n";
+    if( seconds > 0.0 ){
+        std::cout << numSteps / seconds << " steps/sec, " << simulatedSeconds / seconds << " times real time\n";
+    }
+    std::cout << env->getNumObjects() << " objects remain\n";
+
+    delete env;
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include "ObjectStore.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+ObjectStore::ObjectStore(){
+
+    for(int p = 0; p < NUM_PARTITIONS; p++){
+        partitionEnds[p] = 0;
+    }
+
+    // IDs start as 4 so that in future implementation each wall will refer to 0, 1, 2, and 3.
+    Slot wallSlot = { -1, 0 };
+    slots.assign( FIRST_SLOT, wallSlot );
+}
+
+/*! Returns the partition which objects of the given type are stored in */
+ObjectStore::Partition ObjectStore::getPartition(char type){
+
+    switch( type ){
+        case 'r':
+            return ROBOTS;
+        case 't':
+            return TARGETS;
+        case 'o':
+        default:
+            return OBSTACLES;
+    }
+}
+
+int ObjectStore::size() const{
+    return ids.size();
+}
+
+int ObjectStore::begin(Partition partition) const{
+    return ( partition == 0 ) ? 0 : partitionEnds[partition - 1];
+}
+
+int ObjectStore::end(Partition partition) const{
+    return partitionEnds[partition];
+}
+
+/*! Method which adds an object to its partition, handing it a free slot of the slot map */
+int ObjectStore::insert(BaseObject* objPtr, char type, int x, int y, int degrees, int radius){
+
+    // Reusing a freed slot if there is one. Its generation was advanced when it was freed, so the new ID differs
+    // from the IDs of every object which used the slot before.
+    int slot;
+    if( freeSlots.size() > 0 ){
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else{
+        slot = slots.size();
+        if( slot >= ( 1 << SLOT_BITS ) ){
+            std::cout << "Too many objects.  The environment holds at most " << ( 1 << SLOT_BITS ) - FIRST_SLOT << " objects.\n";
+            exit(1);
+        }
+        Slot newSlot = { -1, 0 };
+        slots.push_back( newSlot );
+    }
+    const int newID = ( slots[slot].generation << SLOT_BITS ) | slot;
+
+    // Growing every array by one, then opening a gap at the end of the object's partition by moving the first
+    // object of each later partition to the end of its partition
+    ids.push_back( 0 );
+    objects.push_back( 0 );
+    xs.push_back( 0 );
+    ys.push_back( 0 );
+    orientations.push_back( 0 );
+    radii.push_back( 0 );
+    types.push_back( 0 );
+    obstacleCollisions.push_back( 0 );
+
+    const Partition partition = getPartition( type );
+    int gap = ids.size() - 1;
+    for(int p = NUM_PARTITIONS - 1; p > partition; p--){
+        const int first = begin( static_cast<Partition>( p ) );
+        if( first != gap ){
+            move( first, gap );
+        }
+        gap = first;
+        partitionEnds[p]++;
+    }
+    partitionEnds[partition]++;
+
+    ids[gap] = newID;
+    objects[gap] = objPtr;
+    xs[gap] = x;
+    ys[gap] = y;
+    orientations[gap] = degrees;
+    radii[gap] = radius;
+    types[gap] = type;
+    obstacleCollisions[gap] = false;
+    slots[slot].index = gap;
+
+    return newID;
+}
+
+/*! Method which removes an object by filling its place from the end of its partition, so at most one object of each
+ *  partition has to move */
+void ObjectStore::erase(int objectID){
+
+    const int index = indexOf( objectID );
+    if( index < 0 ){
+        return;
+    }
+
+    const Partition partition = getPartition( types[index] );
+    int gap = index;
+    for(int p = partition; p < NUM_PARTITIONS; p++){
+        const int last = partitionEnds[p] - 1;
+        if( last != gap ){
+            move( last, gap );
+        }
+        gap = last;
+        partitionEnds[p]--;
+    }
+
+    ids.pop_back();
+    objects.pop_back();
+    xs.pop_back();
+    ys.pop_back();
+    orientations.pop_back();
+    radii.pop_back();
+    types.pop_back();
+    obstacleCollisions.pop_back();
+
+    // Freeing the slot. Advancing its generation invalidates the removed object's ID. A slot whose generation
+    // would wrap around is retired instead, since reusing it would give out an ID which was handed out before.
+    const int slot = getSlot( objectID );
+    slots[slot].index = -1;
+    if( slots[slot].generation < MAX_GENERATION ){
+        slots[slot].generation++;
+        freeSlots.push_back( slot );
+    }
+}
+
+/*! Method returns the index at which an object with the given ID resides. The slot bits of the ID select an entry
+ *  of the slot map, which holds the index as long as the generation bits still match. */
+int ObjectStore::indexOf(int objectID) const{
+
+    const int slot = getSlot( objectID );
+    const int generation = objectID >> SLOT_BITS;
+
+    if( objectID < 0 || slot >= static_cast<int>( slots.size() ) || slots[slot].generation != generation ){
+        return -1;
+    }
+    return slots[slot].index;
+}
+
+void ObjectStore::beginIntegration(){
+
+    nextXs.resize( xs.size() );
+    nextYs.resize( ys.size() );
+    nextOrientations.resize( orientations.size() );
+}
+
+/*! Rotates the object by a given amount and translates it forward, writing to the back buffers */
+void ObjectStore::integrate(int index, int degrees, int moveForward){
+
+    const int newDegrees = ( ( ( orientations[index] + degrees ) % 360 ) + 360 ) % 360;
+
+    float radians = 0.01745329 * newDegrees;
+    int xMove = moveForward*cos(radians);
+    int yMove = moveForward*sin(radians);
+
+    nextOrientations[index] = newDegrees;
+    nextXs[index] = xs[index] + xMove;
+    nextYs[index] = ys[index] + yMove;
+}
+
+void ObjectStore::swapBuffers(){
+
+    xs.swap( nextXs );
+    ys.swap( nextYs );
+    orientations.swap( nextOrientations );
+}
+
+void ObjectStore::move(int from, int to){
+
+    ids[to] = ids[from];
+    objects[to] = objects[from];
+    xs[to] = xs[from];
+    ys[to] = ys[from];
+    orientations[to] = orientations[from];
+    radii[to] = radii[from];
+    types[to] = types[from];
+    obstacleCollisions[to] = obstacleCollisions[from];
+
+    slots[ getSlot( ids[to] ) ].index = to;
+}
+
+int ObjectStore::getSlot(int objectID){
+    return objectID & ( ( 1 << SLOT_BITS ) - 1 );
+}
@@ -0,0 +1,175 @@
+/**
+ * \author George Brown
+ *
+ * \file  ObjectStore.hpp
+ * \brief Storage for the state of every object in the environment. Each property is kept in its own contiguous
+ *        array, and objects of the same type are kept next to each other, so the per-frame loops over positions,
+ *        radii, and types read memory in order.
+ *
+ */
+
+#ifndef OBJECT_STORE_HPP
+#define OBJECT_STORE_HPP
+
+#include <vector>
+
+class BaseObject; // forward declaration
+
+/*! The ObjectStore class keeps the position, orientation, radius, type, and collision flag of each object in separate
+ *  arrays which share one index. The arrays are partitioned by type: obstacles first, then targets, then robots.
+ *  Objects are referred to from outside by ID numbers, which stay valid while the objects move around the arrays. */
+class ObjectStore{
+        
+    public:
+        
+        /*! Type partitions, in the order they are stored */
+        enum Partition {
+          OBSTACLES = 0,
+          TARGETS = 1,
+          ROBOTS = 2,
+          NUM_PARTITIONS = 3
+        };
+        
+        /*! An object ID holds the slot of the object in its low SLOT_BITS bits and the slot's generation above them */
+        static const int SLOT_BITS = 22;
+        
+        /*! Largest generation which fits in an ID. Slots which reach it are not reused once freed. */
+        static const int MAX_GENERATION = ( 1 << ( 31 - SLOT_BITS ) ) - 1;
+        
+        /*! Slots below this are never handed out, so that IDs 0, 1, 2, and 3 remain free for the walls */
+        static const int FIRST_SLOT = 4;
+        
+        
+        /*! ObjectStore constructor. The store starts empty. */
+        ObjectStore();
+        
+        
+        /*! Returns the partition which holds objects of a type. Types other than robots and targets are stored
+         *  with the obstacles.
+         * \param type The type specifier of an object */
+        static Partition getPartition(char type);
+        
+        
+        /*! Returns the number of objects in the store */
+        int size() const;
+        
+        
+        /*! Returns the index of the first object of a partition
+         * \param partition The partition */
+        int begin(Partition partition) const;
+        
+        
+        /*! Returns the index just past the last object of a partition
+         * \param partition The partition */
+        int end(Partition partition) const;
+        
+        
+        /*! Adds an object to the end of its type's partition. The first object of each later partition is moved
+         *  to the end of that partition to make room.
+         * \param objPtr A pointer to the object.
+         * \param type The type specifier of the object.
+         * \param x The X-position of the object.
+         * \param y The Y-position of the object.
+         * \param degrees The orientation of the object in degrees.
+         * \param radius The radius of the object.
+         * \return The ID number given to the object */
+        int insert(BaseObject* objPtr, char type, int x, int y, int degrees, int radius);
+        
+        
+        /*! Removes an object. The last object of its partition takes its place, and the last object of each later
+         *  partition moves down by one. The object's slot is freed and its generation advanced, so the removed
+         *  ID is no longer found, even after the slot is reused. The object itself is not deleted.
+         * \param objectID The ID number of the object to remove */
+        void erase(int objectID);
+        
+        
+        /*! Returns the index of the object with a given ID number, in constant time
+         * \param objectID The ID number of the object
+         * \return The index, or -1 if no object in the store has the ID */
+        int indexOf(int objectID) const;
+        
+        
+        /*! Sizes the back buffers of the positions and orientations to match the objects. Must be called before
+         *  the objects are integrated, whenever objects were added or removed since the last swap.
+         */
+        void beginIntegration();
+        
+        
+        /*! Rotates an object by a given amount, then translates it in the direction it then faces. The new state is
+         *  written to the back buffers and the current state is left unchanged, so objects may be integrated in
+         *  any order and on any thread while others read the current state.
+         * \param index The index of the object
+         * \param degrees The number of degrees by which to rotate the object
+         * \param moveForward The amount by which to translate the object */
+        void integrate(int index, int degrees, int moveForward);
+        
+        
+        /*! Makes the states written by integrate current. Every object must have been integrated. */
+        void swapBuffers();
+        
+        
+        /*! Object ID numbers */
+        std::vector<int> ids;
+        
+        /*! Pointers to the objects */
+        std::vector<BaseObject*> objects;
+        
+        /*! Object X-positions */
+        std::vector<int> xs;
+        
+        /*! Object Y-positions */
+        std::vector<int> ys;
+        
+        /*! Object orientations, in degrees from 0 to 359 */
+        std::vector<int> orientations;
+        
+        /*! Object radii */
+        std::vector<int> radii;
+        
+        /*! Object type specifiers */
+        std::vector<char> types;
+        
+        /*! Object-obstacle collision flags, nonzero while the object collides with an obstacle */
+        std::vector<char> obstacleCollisions;
+        
+        
+        /*! Returns the slot bits of an ID number. No two objects in the store share a slot.
+         * \param objectID The ID number */
+        static int getSlot(int objectID);
+        
+        
+    private:
+        
+        /*! Back buffers which integrate writes the next positions and orientations to */
+        std::vector<int> nextXs;
+        std::vector<int> nextYs;
+        std::vector<int> nextOrientations;
+        
+        /*! Entry of the slot map from object IDs to indices */
+        struct Slot{
+        
+            /*! Index of the slot's object, or -1 if the slot is free */
+            int index;
+        
+            /*! Number of times the slot has been freed, wrapped to fit in an ID */
+            int generation;
+        };
+        
+        /*! Index just past the last object of each partition */
+        int partitionEnds[NUM_PARTITIONS];
+        
+        /*! Slot map indexed by the slot bits of object IDs */
+        std::vector<Slot> slots;
+        
+        /*! Free slots, reused before new slots are added */
+        std::vector<int> freeSlots;
+        
+        
+        /*! Copies an object's state from one index to another, and points its slot at the new index
+         * \param from The index the object is moved from
+         * \param to The index the object is moved to */
+        void move(int from, int to);
+        
+};
+
+#endif
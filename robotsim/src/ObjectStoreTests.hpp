@@ -0,0 +1,73 @@
+#include <cxxtest/TestSuite.h>
+
+#include "ObjectStore.hpp"
+
+#include <vector>
+
+using namespace std;
+
+class ObjectStoreTests : public CxxTest::TestSuite {
+
+public:
+       void testPartitionsStayContiguous(void){
+        ObjectStore store;
+        const char types[] = {'r','o','t','r','o','t','r'};
+        for(int i = 0; i < 7; i++){
+            store.insert(0, types[i], i, i, 0, 1);
+        }
+        //every object lies in the range of its type
+        TS_ASSERT_EQUALS(7,store.size());
+        TS_ASSERT_EQUALS(2,store.end(ObjectStore::OBSTACLES));
+        TS_ASSERT_EQUALS(4,store.end(ObjectStore::TARGETS));
+        TS_ASSERT_EQUALS(7,store.end(ObjectStore::ROBOTS));
+        for(int i = 0; i < store.size(); i++){
+            int partition = ObjectStore::getPartition(store.types[i]);
+            TS_ASSERT(i >= store.begin(static_cast<ObjectStore::Partition>(partition)));
+            TS_ASSERT(i < store.end(static_cast<ObjectStore::Partition>(partition)));
+        }
+       }
+
+
+       void testIDsFollowMovedObjects(void){
+        ObjectStore store;
+        vector<int> ids;
+        const char types[] = {'o','t','r','o','t','r'};
+        for(int i = 0; i < 6; i++){
+            ids.push_back(store.insert(0, types[i], 10*i, 0, 0, 1));
+        }
+        //the first IDs are 4, 5, 6, ...
+        TS_ASSERT_EQUALS(4,ids[0]);
+        TS_ASSERT_EQUALS(9,ids[5]);
+        //removing an obstacle moves objects of every partition, but each ID still finds its own object
+        store.erase(ids[0]);
+        TS_ASSERT_EQUALS(-1,store.indexOf(ids[0]));
+        for(int i = 1; i < 6; i++){
+            TS_ASSERT_EQUALS(10*i,store.xs[store.indexOf(ids[i])]);
+        }
+        //the freed slot is reused under a new ID
+        int newID = store.insert(0, 'r', 60, 0, 0, 1);
+        TS_ASSERT(newID != ids[0]);
+        TS_ASSERT_EQUALS(-1,store.indexOf(ids[0]));
+        TS_ASSERT_EQUALS(60,store.xs[store.indexOf(newID)]);
+       }
+
+
+
+       void testStaleIDsStayInvalidAfterManyReuses(void){
+        ObjectStore store;
+        int staleID = store.insert(0, 't', 0, 0, 0, 1);
+        store.erase(staleID);
+        //cycling the same slot through every generation, and then some
+        for(int i = 0; i < 600; i++){
+            int id = store.insert(0, 'o', i, 0, 0, 1);
+            TS_ASSERT(id != staleID);
+            TS_ASSERT_EQUALS(-1,store.indexOf(staleID));
+            store.erase(id);
+        }
+        int newID = store.insert(0, 'r', 1, 0, 0, 1);
+        TS_ASSERT(newID != staleID);
+        TS_ASSERT_EQUALS(-1,store.indexOf(staleID));
+        TS_ASSERT_EQUALS(0,store.indexOf(newID));
+       }
+
+};
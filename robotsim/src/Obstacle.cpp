@@ -1,7 +1,7 @@
 #include "Obstacle.hpp"
 
-Obstacle::Obstacle(int speedRating)
-    : BaseObject('o',speedRating){
+Obstacle::Obstacle(Environment* env, int speedRating)
+    : BaseObject(env,'o',speedRating){
 }
 
 Obstacle::~Obstacle(){
@@ -21,8 +21,9 @@ class Obstacle : public BaseObject{
     public:
     
         /*! The constructor for the Obstacle
+         * \param env The environment which the obstacle resides in
          * \param speedRating The speed setting for a newly created obstacle */
-        Obstacle(int speedRating);
+        Obstacle(Environment* env, int speedRating);
     
         /*! Obstacle Destructor */
         ~Obstacle();
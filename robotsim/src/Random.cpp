@@ -0,0 +1,39 @@
+#include "Random.hpp"
+
+Random::Random(uint64_t seed, uint64_t stream){
+
+    this->seed = seed;
+    key = mix( seed ^ mix( stream + 0x9E3779B97F4A7C15ULL ) );
+    counter = 0;
+}
+
+uint64_t Random::getSeed() const{
+    return seed;
+}
+
+uint32_t Random::next(){
+
+    const uint32_t value = mix( key + 0x9E3779B97F4A7C15ULL * counter ) >> 32;
+    counter++;
+    return value;
+}
+
+/*! Method which maps 32 random bits onto [0, n) by multiplying instead of taking a remainder, which is faster and
+ *  does not favour low values as much */
+int Random::nextInt(int n){
+    return ( static_cast<uint64_t>( next() ) * static_cast<uint64_t>( n ) ) >> 32;
+}
+
+uint32_t Random::at(uint64_t seed, uint64_t stream, uint64_t counter){
+
+    Random random( seed, stream );
+    random.counter = counter;
+    return random.next();
+}
+
+uint64_t Random::mix(uint64_t x){
+
+    x = ( x ^ ( x >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    x = ( x ^ ( x >> 27 ) ) * 0x94D049BB133111EBULL;
+    return x ^ ( x >> 31 );
+}
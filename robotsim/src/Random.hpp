@@ -0,0 +1,65 @@
+/**
+ * \author George Brown
+ *
+ * \file  Random.hpp
+ * \brief A counter-based random number generator. Each number is a hash of the seed, a stream number, and the
+ *        count of numbers drawn before it, so runs with the same seed are repeatable and separate streams can be
+ *        drawn from on separate threads without sharing any state.
+ *
+ */
+
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+
+/*! The Random class draws numbers from one stream of a seeded counter-based generator. Two generators with the same
+ *  seed and stream produce the same numbers, and generators with different streams produce unrelated numbers. */
+class Random{
+        
+    public:
+        
+        /*! Random constructor.
+         * \param seed The seed shared by all streams of a run.
+         * \param stream The stream to draw from. */
+        Random(uint64_t seed, uint64_t stream = 0);
+        
+        
+        /*! Returns the seed of the generator */
+        uint64_t getSeed() const;
+        
+        
+        /*! Returns the next 32 random bits of the stream */
+        uint32_t next();
+        
+        
+        /*! Returns a random integer from 0 up to but not including n
+         * \param n The number of possible values, which must be positive */
+        int nextInt(int n);
+        
+        
+        /*! Computes the number at a position of a stream without a generator. This is what next returns.
+         * \param seed The seed shared by all streams of a run.
+         * \param stream The stream.
+         * \param counter The position in the stream. */
+        static uint32_t at(uint64_t seed, uint64_t stream, uint64_t counter);
+        
+        
+    private:
+        
+        /*! The seed shared by all streams */
+        uint64_t seed;
+        
+        /*! Key mixed from the seed and stream, which every number of the stream is derived from */
+        uint64_t key;
+        
+        /*! Count of numbers drawn so far */
+        uint64_t counter;
+        
+        
+        /*! Scrambles the bits of a 64-bit value, using the finalizer of SplitMix64 */
+        static uint64_t mix(uint64_t x);
+        
+};
+
+#endif
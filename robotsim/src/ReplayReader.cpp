@@ -0,0 +1,308 @@
+#include "ReplayReader.hpp"
+#include "ReplayWriter.hpp"
+#include "ObjectStore.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/*! Number of bytes in the header of a log, and in the part of each record before its length */
+static const int HEADER_SIZE = 20;
+static const int RECORD_PREFIX_SIZE = 5;
+
+ReplayReader::ReplayReader(const char* path)
+    : file(path, std::ios::binary){
+
+    if( !file ){
+        std::cout << "Could not open replay log " << path << ".\n";
+        exit(1);
+    }
+
+    // Checking the header
+    record.resize( HEADER_SIZE );
+    file.read( reinterpret_cast<char*>( record.data() ), HEADER_SIZE );
+    if( !file || memcmp( record.data(), ReplayWriter::MAGIC, 4 ) != 0 ){
+        std::cout << path << " is not a replay log.\n";
+        exit(1);
+    }
+    readPosition = 4;
+    if( getFixed() != ReplayWriter::VERSION ){
+        std::cout << path << " was written by an unknown version of the replay log format.\n";
+        exit(1);
+    }
+    getFixed();
+    width = getFixed();
+    height = getFixed();
+
+    frame = -1;
+    elapsedTime = 0;
+    scanFrames();
+    seek( 0 );
+}
+
+int ReplayReader::getNumFrames() const{
+    return frameOffsets.size();
+}
+
+int ReplayReader::getNumKeyframes() const{
+    return keyframes.size();
+}
+
+int ReplayReader::getWidth() const{
+    return width;
+}
+
+int ReplayReader::getHeight() const{
+    return height;
+}
+
+int ReplayReader::getFrame() const{
+    return frame;
+}
+
+int ReplayReader::getElapsedTime() const{
+    return elapsedTime;
+}
+
+int ReplayReader::getNumObjects() const{
+    return ids.size();
+}
+
+int ReplayReader::getObjectID(const int index) const{
+    return ids[index];
+}
+
+char ReplayReader::getObjectType(const int index) const{
+    return types[index];
+}
+
+std::pair<int,int> ReplayReader::getObjectPosition(const int index) const{
+    return std::make_pair( xs[index], ys[index] );
+}
+
+int ReplayReader::getObjectOrientation(const int index) const{
+    return orientations[index];
+}
+
+int ReplayReader::getObjectRadius(const int index) const{
+    return radii[index];
+}
+
+bool ReplayReader::getObjectObstacleCollisionStatus(const int index) const{
+    return obstacleCollisions[index];
+}
+
+/*! Method which loads a frame by decoding forward from the last keyframe at or before it, or from the loaded frame
+ *  if that is nearer */
+bool ReplayReader::seek(int target){
+
+    if( target < 0 || target >= getNumFrames() ){
+        return false;
+    }
+
+    const int keyframe = *( std::upper_bound( keyframes.begin(), keyframes.end(), target ) - 1 );
+    const int first = ( frame >= keyframe && frame <= target ) ? frame + 1 : keyframe;
+
+    for(int f = first; f <= target; f++){
+        readFrame( f );
+    }
+    return true;
+}
+
+/*! Method which reads the tag and length of each record to find where it starts, without decoding it */
+void ReplayReader::scanFrames(){
+
+    file.seekg( 0, std::ios::end );
+    const std::streamoff fileSize = file.tellg();
+
+    std::streamoff offset = HEADER_SIZE;
+    unsigned char prefix[RECORD_PREFIX_SIZE];
+
+    while( offset + RECORD_PREFIX_SIZE <= fileSize ){
+
+        file.seekg( offset );
+        file.read( reinterpret_cast<char*>( prefix ), RECORD_PREFIX_SIZE );
+
+        const char tag = prefix[0];
+        const std::streamoff length = prefix[1] | ( prefix[2] << 8 ) | ( prefix[3] << 16 ) |
+                                      ( static_cast<std::streamoff>( prefix[4] ) << 24 );
+        const std::streamoff end = offset + RECORD_PREFIX_SIZE + length;
+
+        if( ( tag != ReplayWriter::KEYFRAME && tag != ReplayWriter::DELTA ) || end > fileSize ){
+            break;
+        }
+        // A log must start with a keyframe, for the deltas after it to apply to
+        if( frameOffsets.size() == 0 && tag != ReplayWriter::KEYFRAME ){
+            break;
+        }
+
+        if( tag == ReplayWriter::KEYFRAME ){
+            keyframes.push_back( frameOffsets.size() );
+        }
+        frameOffsets.push_back( offset );
+        offset = end;
+    }
+    file.clear();
+}
+
+void ReplayReader::readFrame(int frameNumber){
+
+    // Reading the whole record into the reused buffer
+    unsigned char prefix[RECORD_PREFIX_SIZE];
+    file.seekg( frameOffsets[frameNumber] );
+    file.read( reinterpret_cast<char*>( prefix ), RECORD_PREFIX_SIZE );
+    const size_t length = prefix[1] | ( prefix[2] << 8 ) | ( prefix[3] << 16 ) | ( static_cast<size_t>( prefix[4] ) << 24 );
+    record.resize( length );
+    file.read( reinterpret_cast<char*>( record.data() ), length );
+    readPosition = 0;
+
+    if( !file || static_cast<int>( getFixed() ) != frameNumber ){
+        std::cout << "The replay log is damaged at frame " << frameNumber << ".\n";
+        exit(1);
+    }
+    elapsedTime = getFixed();
+
+    if( prefix[0] == ReplayWriter::KEYFRAME ){
+
+        // Emptying the state without giving back its memory
+        for(int i = 0; i < getNumObjects(); i++){
+            slotIndices[ ObjectStore::getSlot( ids[i] ) ] = -1;
+        }
+        ids.clear();
+        types.clear();
+        xs.clear();
+        ys.clear();
+        orientations.clear();
+        radii.clear();
+        obstacleCollisions.clear();
+
+        const uint32_t numObjects = getVarint();
+        for(uint32_t i = 0; i < numObjects; i++){
+            ids.push_back( getVarint() );
+            addObject();
+        }
+    }
+    else{
+
+        const uint32_t numRemoved = getFixed();
+        for(uint32_t i = 0; i < numRemoved; i++){
+            removeObject( getVarint() );
+        }
+
+        const uint32_t numChanged = getFixed();
+        for(uint32_t i = 0; i < numChanged; i++){
+
+            const int id = getVarint();
+            const int changes = getByte();
+
+            if( changes & ReplayWriter::CHANGED_NEW ){
+                ids.push_back( id );
+                addObject();
+                continue;
+            }
+
+            const int index = indexOf( id );
+            if( changes & ReplayWriter::CHANGED_POSITION ){
+                xs[index] = static_cast<uint32_t>( xs[index] ) + static_cast<uint32_t>( getSigned() );
+                ys[index] = static_cast<uint32_t>( ys[index] ) + static_cast<uint32_t>( getSigned() );
+            }
+            if( changes & ReplayWriter::CHANGED_ORIENTATION ){
+                orientations[index] = getVarint();
+            }
+            if( changes & ReplayWriter::CHANGED_FLAGS ){
+                obstacleCollisions[index] = getByte();
+            }
+        }
+    }
+
+    frame = frameNumber;
+}
+
+/*! Method which decodes the state of the object whose ID was just appended to the IDs */
+void ReplayReader::addObject(){
+
+    types.push_back( getByte() );
+    xs.push_back( getSigned() );
+    ys.push_back( getSigned() );
+    orientations.push_back( getVarint() );
+    radii.push_back( getVarint() );
+    obstacleCollisions.push_back( getByte() );
+
+    const int slot = ObjectStore::getSlot( ids.back() );
+    if( slot >= static_cast<int>( slotIndices.size() ) ){
+        slotIndices.resize( slot + 1, -1 );
+    }
+    slotIndices[slot] = ids.size() - 1;
+}
+
+/*! Method which removes an object by moving the last object into its place */
+void ReplayReader::removeObject(int objectID){
+
+    const int index = indexOf( objectID );
+    const int last = ids.size() - 1;
+
+    ids[index] = ids[last];
+    types[index] = types[last];
+    xs[index] = xs[last];
+    ys[index] = ys[last];
+    orientations[index] = orientations[last];
+    radii[index] = radii[last];
+    obstacleCollisions[index] = obstacleCollisions[last];
+    slotIndices[ ObjectStore::getSlot( ids[index] ) ] = index;
+    slotIndices[ ObjectStore::getSlot( objectID ) ] = -1;
+
+    ids.pop_back();
+    types.pop_back();
+    xs.pop_back();
+    ys.pop_back();
+    orientations.pop_back();
+    radii.pop_back();
+    obstacleCollisions.pop_back();
+}
+
+int ReplayReader::indexOf(int objectID) const{
+
+    const int slot = ObjectStore::getSlot( objectID );
+    if( slot >= static_cast<int>( slotIndices.size() ) || slotIndices[slot] < 0 || ids[ slotIndices[slot] ] != objectID ){
+        std::cout << "The replay log refers to object " << objectID << ", which is not in frame " << frame << ".\n";
+        exit(1);
+    }
+    return slotIndices[slot];
+}
+
+unsigned char ReplayReader::getByte(){
+
+    if( readPosition >= record.size() ){
+        std::cout << "The replay log has a record which ends too early.\n";
+        exit(1);
+    }
+    return record[readPosition++];
+}
+
+uint32_t ReplayReader::getFixed(){
+
+    uint32_t value = 0;
+    for(int i = 0; i < 4; i++){
+        value |= static_cast<uint32_t>( getByte() ) << ( 8*i );
+    }
+    return value;
+}
+
+uint32_t ReplayReader::getVarint(){
+
+    uint32_t value = 0;
+    for(int shift = 0; shift < 35; shift += 7){
+        const unsigned char byte = getByte();
+        value |= static_cast<uint32_t>( byte & 0x7F ) << shift;
+        if( ( byte & 0x80 ) == 0 ){
+            break;
+        }
+    }
+    return value;
+}
+
+int32_t ReplayReader::getSigned(){
+
+    const uint32_t value = getVarint();
+    return static_cast<int32_t>( ( value >> 1 ) ^ ( 0u - ( value & 1 ) ) );
+}
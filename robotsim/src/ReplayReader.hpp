@@ -0,0 +1,141 @@
+/**
+ * \author George Brown
+ *
+ * \file  ReplayReader.hpp
+ * \brief Plays back a replay log written by a ReplayWriter. Any frame can be loaded, by decoding the nearest
+ *        keyframe before it and the deltas which follow.
+ *
+ */
+
+#ifndef REPLAY_READER_HPP
+#define REPLAY_READER_HPP
+
+#include <vector>
+#include <fstream>
+#include <utility>
+#include <cstdint>
+
+/*! The ReplayReader class holds the state of the objects at one frame of a replay log. Opening a log scans it once
+ *  to find where each frame starts. A log cut short, for example by a crash, can be played back up to the last
+ *  frame which was written completely. */
+class ReplayReader{
+        
+    public:
+        
+        /*! ReplayReader constructor. Opens the log and loads frame 0, if there is one.
+         * \param path The path of the log file. */
+        ReplayReader(const char* path);
+        
+        
+        /*! Returns the number of frames in the log */
+        int getNumFrames() const;
+        
+        
+        /*! Returns the number of keyframes in the log */
+        int getNumKeyframes() const;
+        
+        
+        /*! Returns the width and height of the recorded environment */
+        int getWidth() const;
+        int getHeight() const;
+        
+        
+        /*! Loads the state at a frame. Moving forward from the loaded frame only decodes the frames in between,
+         *  unless a keyframe is nearer.
+         * \param frame The frame number.
+         * \return True if the log has the frame. */
+        bool seek(int frame);
+        
+        
+        /*! Returns the number of the loaded frame, or -1 before any frame is loaded */
+        int getFrame() const;
+        
+        
+        /*! Returns the milliseconds simulated by the update which produced the loaded frame */
+        int getElapsedTime() const;
+        
+        
+        /*! Returns the number of objects in the loaded frame */
+        int getNumObjects() const;
+        
+        
+        /*! Returns the state of an object in the loaded frame, referenced by index. Indices are not the same as
+         *  in the recorded environment, but IDs are.
+         * \param index An index into the objects of the loaded frame */
+        int getObjectID(const int index) const;
+        char getObjectType(const int index) const;
+        std::pair<int,int> getObjectPosition(const int index) const;
+        int getObjectOrientation(const int index) const;
+        int getObjectRadius(const int index) const;
+        bool getObjectObstacleCollisionStatus(const int index) const;
+        
+        
+    private:
+        
+        /*! The log file */
+        std::ifstream file;
+        
+        /*! Dimensions of the recorded environment */
+        int width;
+        int height;
+        
+        /*! Offset in the file of the record of each frame */
+        std::vector<std::streamoff> frameOffsets;
+        
+        /*! Numbers of the frames which are keyframes, in order */
+        std::vector<int> keyframes;
+        
+        /*! The record being decoded, and the position of the next byte to decode */
+        std::vector<unsigned char> record;
+        size_t readPosition;
+        
+        /*! The loaded frame, and the milliseconds simulated by its update */
+        int frame;
+        int elapsedTime;
+        
+        /*! State of the objects in the loaded frame */
+        std::vector<int> ids;
+        std::vector<char> types;
+        std::vector<int> xs;
+        std::vector<int> ys;
+        std::vector<int> orientations;
+        std::vector<int> radii;
+        std::vector<char> obstacleCollisions;
+        
+        /*! Index of the object in each slot, indexed by the slot bits of object IDs, or -1 for empty slots */
+        std::vector<int> slotIndices;
+        
+        
+        /*! Finds the record of every frame, stopping at the end of the file or at a record cut short */
+        void scanFrames();
+        
+        
+        /*! Reads the record of a frame and applies it to the loaded state. A keyframe replaces the state, and a
+         *  delta changes it, so it must follow the frame before it.
+         * \param frameNumber The frame to read. */
+        void readFrame(int frameNumber);
+        
+        
+        /*! Decodes the full state of an object and adds it to the loaded state */
+        void addObject();
+        
+        
+        /*! Removes an object from the loaded state
+         * \param objectID The ID of the object */
+        void removeObject(int objectID);
+        
+        
+        /*! Returns the index of an object in the loaded state, or exits if the log has no such object */
+        int indexOf(int objectID) const;
+        
+        
+        /*! Decodes a byte, a 4-byte little-endian integer, a variable-length integer, or a zigzag-encoded
+         *  variable-length integer from the record, or exits if the record is too short */
+        unsigned char getByte();
+        uint32_t getFixed();
+        uint32_t getVarint();
+        int32_t getSigned();
+        
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include <cxxtest/TestSuite.h>
+
+#include "Environment.hpp"
+#include "ReplayReader.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+class ReplayTests : public CxxTest::TestSuite {
+
+public:
+       //state of every object, sorted so that it does not depend on the order objects are listed in
+       typedef vector< vector<int> > Snapshot;
+
+       static Snapshot snapshot(Environment* env){
+        Snapshot state;
+        for(int i = 0; i < env->getNumObjects(); i++){
+            vector<int> object;
+            object.push_back(env->getObjectType(i));
+            object.push_back(env->getObjectPosition(i).first);
+            object.push_back(env->getObjectPosition(i).second);
+            object.push_back(env->getObjectOrientation(i));
+            object.push_back(env->getObjectRadius(i));
+            object.push_back(env->getObjectObstacleCollisionStatus(i));
+            state.push_back(object);
+        }
+        sort(state.begin(),state.end());
+        return state;
+       }
+
+       static Snapshot snapshot(ReplayReader& replay){
+        Snapshot state;
+        for(int i = 0; i < replay.getNumObjects(); i++){
+            vector<int> object;
+            object.push_back(replay.getObjectType(i));
+            object.push_back(replay.getObjectPosition(i).first);
+            object.push_back(replay.getObjectPosition(i).second);
+            object.push_back(replay.getObjectOrientation(i));
+            object.push_back(replay.getObjectRadius(i));
+            object.push_back(replay.getObjectObstacleCollisionStatus(i));
+            state.push_back(object);
+        }
+        sort(state.begin(),state.end());
+        return state;
+       }
+
+
+       void testPlaybackMatchesSimulation(void){
+        const char* path = "replay_test.rsrp";
+        Environment* env = new Environment(800,800,1000,30,20,10,9);
+        env->startRecording(path,50);
+        //frames which are keyframes, deltas just after and before keyframes, and the last frame
+        const int frames[] = {0,1,37,49,50,51,100,249};
+        vector<Snapshot> expected;
+        expected.push_back(snapshot(env));
+        int next = 1;
+        for(int step = 1; step <= 249; step++){
+            env->update(33);
+            if( step == frames[next] ){
+                expected.push_back(snapshot(env));
+                next++;
+            }
+        }
+        //robots and targets met, so objects were removed while recording
+        TS_ASSERT(env->getNumObjects() < 60);
+        env->stopRecording();
+
+        ReplayReader replay(path);
+        TS_ASSERT_EQUALS(250,replay.getNumFrames());
+        TS_ASSERT_EQUALS(5,replay.getNumKeyframes());
+        TS_ASSERT_EQUALS(800*1000,replay.getWidth());
+        //seeking backwards, forwards, and to the same frame all give the recorded state
+        const int order[] = {7,2,3,0,6,4,5,1,1};
+        for(int k = 0; k < 9; k++){
+            TS_ASSERT(replay.seek(frames[order[k]]));
+            TS_ASSERT_EQUALS(frames[order[k]],replay.getFrame());
+            TS_ASSERT(expected[order[k]] == snapshot(replay));
+        }
+        TS_ASSERT(!replay.seek(250));
+        delete env;
+        remove(path);
+       }
+
+
+       void testLogCutShortPlaysBackCompleteFrames(void){
+        const char* path = "replay_cut.rsrp";
+        Environment* env = new Environment(800,800,1000,5,5,5,2);
+        env->startRecording(path,10);
+        for(int step = 0; step < 30; step++){
+            env->update(33);
+        }
+        delete env;
+        //dropping the last few bytes, as a crash while writing would
+        FILE* file = fopen(path,"rb");
+        vector<char> bytes(1 << 20);
+        size_t size = fread(&bytes[0],1,bytes.size(),file);
+        fclose(file);
+        file = fopen(path,"wb");
+        fwrite(&bytes[0],1,size - 3,file);
+        fclose(file);
+
+        ReplayReader replay(path);
+        TS_ASSERT_EQUALS(30,replay.getNumFrames());
+        TS_ASSERT(replay.seek(29));
+        remove(path);
+       }
+
+};
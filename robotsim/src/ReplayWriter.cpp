@@ -0,0 +1,213 @@
+#include "ReplayWriter.hpp"
+#include <cstdlib>
+#include <iostream>
+
+const char ReplayWriter::MAGIC[4] = { 'R', 'S', 'R', 'P' };
+
+ReplayWriter::ReplayWriter(const char* path, int width, int height, int keyframeInterval)
+    : file(path, std::ios::binary | std::ios::trunc){
+
+    if( !file ){
+        std::cout << "Could not open replay log " << path << " for writing.\n";
+        exit(1);
+    }
+
+    this->keyframeInterval = ( keyframeInterval > 0 ) ? keyframeInterval : DEFAULT_KEYFRAME_INTERVAL;
+    numFrames = 0;
+    buffer.reserve( 2*FLUSH_SIZE );
+
+    for(int i = 0; i < 4; i++){
+        putByte( MAGIC[i] );
+    }
+    putFixed( VERSION );
+    putFixed( this->keyframeInterval );
+    putFixed( width );
+    putFixed( height );
+}
+
+ReplayWriter::~ReplayWriter(){
+    flush();
+}
+
+int ReplayWriter::getNumFrames() const{
+    return numFrames;
+}
+
+/*! Method which appends a frame record. Every keyframeInterval frames the full state is written, and the frames
+ *  in between only hold what changed since the frame before them. */
+void ReplayWriter::recordFrame(const ObjectStore& store, int elapsedTime){
+
+    const bool isKeyframe = ( numFrames % keyframeInterval == 0 );
+
+    putByte( isKeyframe ? KEYFRAME : DELTA );
+    const size_t lengthPosition = buffer.size();
+    putFixed( 0 );
+    putFixed( numFrames );
+    putFixed( elapsedTime );
+
+    if( isKeyframe ){
+        writeKeyframe( store );
+    }
+    else{
+        writeDelta( store );
+    }
+
+    patchFixed( lengthPosition, buffer.size() - lengthPosition - 4 );
+    liveIDs.assign( store.ids.begin(), store.ids.end() );
+    numFrames++;
+
+    if( buffer.size() >= static_cast<size_t>( FLUSH_SIZE ) ){
+        flush();
+    }
+}
+
+void ReplayWriter::flush(){
+
+    file.write( reinterpret_cast<const char*>( buffer.data() ), buffer.size() );
+    file.flush();
+    buffer.clear();
+}
+
+void ReplayWriter::writeKeyframe(const ObjectStore& store){
+
+    // Forgetting the previous frame, since the keyframe replaces it
+    for(int i = 0; i < static_cast<int>( liveIDs.size() ); i++){
+        lastIDs[ ObjectStore::getSlot( liveIDs[i] ) ] = -1;
+    }
+
+    putVarint( store.size() );
+    for(int i = 0; i < store.size(); i++){
+        putVarint( store.ids[i] );
+        putObject( store, i );
+        remember( store, i );
+    }
+}
+
+void ReplayWriter::writeDelta(const ObjectStore& store){
+
+    // Listing the objects of the previous frame which are gone
+    uint32_t numRemoved = 0;
+    const size_t removedPosition = buffer.size();
+    putFixed( 0 );
+    for(int i = 0; i < static_cast<int>( liveIDs.size() ); i++){
+        if( store.indexOf( liveIDs[i] ) < 0 ){
+            putVarint( liveIDs[i] );
+            lastIDs[ ObjectStore::getSlot( liveIDs[i] ) ] = -1;
+            numRemoved++;
+        }
+    }
+    patchFixed( removedPosition, numRemoved );
+
+    // Listing the objects which are new or changed, with only the fields which changed
+    uint32_t numChanged = 0;
+    const size_t changedPosition = buffer.size();
+    putFixed( 0 );
+    for(int i = 0; i < store.size(); i++){
+
+        const int id = store.ids[i];
+        const int slot = ObjectStore::getSlot( id );
+
+        if( slot >= static_cast<int>( lastIDs.size() ) || lastIDs[slot] != id ){
+            putVarint( id );
+            putByte( CHANGED_NEW );
+            putObject( store, i );
+            remember( store, i );
+            numChanged++;
+            continue;
+        }
+
+        int changes = 0;
+        if( store.xs[i] != lastXs[slot] || store.ys[i] != lastYs[slot] ){
+            changes |= CHANGED_POSITION;
+        }
+        if( store.orientations[i] != lastOrientations[slot] ){
+            changes |= CHANGED_ORIENTATION;
+        }
+        if( store.obstacleCollisions[i] != lastFlags[slot] ){
+            changes |= CHANGED_FLAGS;
+        }
+        if( changes == 0 ){
+            continue;
+        }
+
+        putVarint( id );
+        putByte( changes );
+        if( changes & CHANGED_POSITION ){
+            // Differences wrap around like the unsigned arithmetic which the reader undoes them with
+            putSigned( static_cast<uint32_t>( store.xs[i] ) - static_cast<uint32_t>( lastXs[slot] ) );
+            putSigned( static_cast<uint32_t>( store.ys[i] ) - static_cast<uint32_t>( lastYs[slot] ) );
+        }
+        if( changes & CHANGED_ORIENTATION ){
+            putVarint( store.orientations[i] );
+        }
+        if( changes & CHANGED_FLAGS ){
+            putByte( store.obstacleCollisions[i] );
+        }
+        remember( store, i );
+        numChanged++;
+    }
+    patchFixed( changedPosition, numChanged );
+}
+
+/*! Method which stores an object's state in the arrays indexed by slot, growing them for new slots */
+void ReplayWriter::remember(const ObjectStore& store, int index){
+
+    const int slot = ObjectStore::getSlot( store.ids[index] );
+    if( slot >= static_cast<int>( lastIDs.size() ) ){
+        lastIDs.resize( slot + 1, -1 );
+        lastXs.resize( slot + 1 );
+        lastYs.resize( slot + 1 );
+        lastOrientations.resize( slot + 1 );
+        lastFlags.resize( slot + 1 );
+    }
+
+    lastIDs[slot] = store.ids[index];
+    lastXs[slot] = store.xs[index];
+    lastYs[slot] = store.ys[index];
+    lastOrientations[slot] = store.orientations[index];
+    lastFlags[slot] = store.obstacleCollisions[index];
+}
+
+void ReplayWriter::putObject(const ObjectStore& store, int index){
+
+    putByte( store.types[index] );
+    putSigned( store.xs[index] );
+    putSigned( store.ys[index] );
+    putVarint( store.orientations[index] );
+    putVarint( store.radii[index] );
+    putByte( store.obstacleCollisions[index] );
+}
+
+void ReplayWriter::putByte(unsigned char value){
+    buffer.push_back( value );
+}
+
+void ReplayWriter::putFixed(uint32_t value){
+
+    for(int i = 0; i < 4; i++){
+        buffer.push_back( ( value >> ( 8*i ) ) & 0xFF );
+    }
+}
+
+/*! Method which writes 7 bits per byte, lowest first, setting the top bit of every byte but the last */
+void ReplayWriter::putVarint(uint32_t value){
+
+    while( value >= 0x80 ){
+        buffer.push_back( ( value & 0x7F ) | 0x80 );
+        value >>= 7;
+    }
+    buffer.push_back( value );
+}
+
+/*! Method which maps signed values to unsigned ones, 0, -1, 1, -2, ... to 0, 1, 2, 3, ..., so values near zero
+ *  stay short */
+void ReplayWriter::putSigned(int32_t value){
+    putVarint( ( static_cast<uint32_t>( value ) << 1 ) ^ static_cast<uint32_t>( value >> 31 ) );
+}
+
+void ReplayWriter::patchFixed(size_t position, uint32_t value){
+
+    for(int i = 0; i < 4; i++){
+        buffer[position + i] = ( value >> ( 8*i ) ) & 0xFF;
+    }
+}
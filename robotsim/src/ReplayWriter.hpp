@@ -0,0 +1,151 @@
+/**
+ * \author George Brown
+ *
+ * \file  ReplayWriter.hpp
+ * \brief Records the state of an environment after every update to a compact binary replay log, which a
+ *        ReplayReader can later play back from any frame.
+ *
+ * The log starts with a header: the bytes "RSRP", then the format version, the keyframe interval, and the
+ * environment width and height, each as a 4-byte little-endian integer. A record for each frame follows:
+ *
+ *   tag            1 byte, KEYFRAME or DELTA
+ *   length         4 bytes, the number of bytes in the rest of the record
+ *   frame          4 bytes, the frame number, counting from 0
+ *   elapsed time   4 bytes, the milliseconds simulated by the update which produced the frame
+ *
+ * A keyframe then holds the number of objects and the full state of each one: its ID, type, position,
+ * orientation, radius, and obstacle collision flag. A delta holds the number of objects removed since the
+ * previous frame and their IDs, then the number of new or changed objects, each with its ID, a byte of CHANGED_
+ * bits, and the fields which those bits select. The counts in deltas take 4 bytes. Other counts, IDs,
+ * orientations, and radii are stored as variable-length integers of 7 bits per byte, and positions and position
+ * changes as zigzag-encoded variable-length integers.
+ *
+ */
+
+#ifndef REPLAY_WRITER_HPP
+#define REPLAY_WRITER_HPP
+
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "ObjectStore.hpp"
+
+/*! The ReplayWriter class appends one record per frame to a replay log. Records are collected in a buffer which
+ *  is written out once it is full, and the state remembered from the previous frame is kept in arrays which are
+ *  reused, so recording a frame allocates no memory once the number of objects stops growing. */
+class ReplayWriter{
+        
+    public:
+        
+        /*! Bytes which start every replay log, and the version of the format */
+        static const char MAGIC[4];
+        static const int VERSION = 1;
+        
+        /*! Record tags */
+        static const char KEYFRAME = 'K';
+        static const char DELTA = 'D';
+        
+        /*! Bits which mark the fields stored for a changed object in a delta. A new object has all its fields. */
+        static const int CHANGED_POSITION = 1;
+        static const int CHANGED_ORIENTATION = 2;
+        static const int CHANGED_FLAGS = 4;
+        static const int CHANGED_NEW = 8;
+        
+        /*! Number of frames between keyframes when none is given */
+        static const int DEFAULT_KEYFRAME_INTERVAL = 100;
+        
+        /*! Size the buffer reaches before it is written to the file */
+        static const int FLUSH_SIZE = 1 << 16;
+        
+        
+        /*! ReplayWriter constructor. Creates the log file and writes its header.
+         * \param path The path of the log file, which is replaced if it exists.
+         * \param width The width of the environment.
+         * \param height The height of the environment.
+         * \param keyframeInterval The number of frames between keyframes. */
+        ReplayWriter(const char* path, int width, int height, int keyframeInterval);
+        
+        
+        /*! ReplayWriter destructor. Writes out the buffered frames and closes the file. */
+        ~ReplayWriter();
+        
+        
+        /*! Replay writers own their file, so they are not copied */
+        ReplayWriter(const ReplayWriter&) = delete;
+        ReplayWriter& operator=(const ReplayWriter&) = delete;
+        
+        
+        /*! Records the state of every object as the next frame
+         * \param store The object store of the environment being recorded.
+         * \param elapsedTime The milliseconds simulated since the previous frame. */
+        void recordFrame(const ObjectStore& store, int elapsedTime);
+        
+        
+        /*! Writes the buffered frames to the file */
+        void flush();
+        
+        
+        /*! Returns the number of frames recorded */
+        int getNumFrames() const;
+        
+        
+    private:
+        
+        /*! The log file */
+        std::ofstream file;
+        
+        /*! Bytes not yet written to the file */
+        std::vector<unsigned char> buffer;
+        
+        /*! Number of frames between keyframes */
+        int keyframeInterval;
+        
+        /*! Number of frames recorded */
+        int numFrames;
+        
+        /*! State of each object in the previous frame, indexed by the slot bits of its ID. The ID is -1 for
+         *  slots which held no object. */
+        std::vector<int> lastIDs;
+        std::vector<int> lastXs;
+        std::vector<int> lastYs;
+        std::vector<int> lastOrientations;
+        std::vector<char> lastFlags;
+        
+        /*! IDs of the objects in the previous frame */
+        std::vector<int> liveIDs;
+        
+        
+        /*! Writes the full state of every object */
+        void writeKeyframe(const ObjectStore& store);
+        
+        
+        /*! Writes the objects removed since the previous frame, and the fields which changed for the others */
+        void writeDelta(const ObjectStore& store);
+        
+        
+        /*! Remembers the state of an object for the next delta
+         * \param store The object store.
+         * \param index The index of the object in the store. */
+        void remember(const ObjectStore& store, int index);
+        
+        
+        /*! Writes the full state of an object but its ID, as stored in keyframes and for new objects in deltas */
+        void putObject(const ObjectStore& store, int index);
+        
+        
+        /*! Appends a byte, a 4-byte little-endian integer, a variable-length integer, or a zigzag-encoded
+         *  variable-length integer to the buffer */
+        void putByte(unsigned char value);
+        void putFixed(uint32_t value);
+        void putVarint(uint32_t value);
+        void putSigned(int32_t value);
+        
+        
+        /*! Overwrites a 4-byte little-endian integer which was appended earlier
+         * \param position The index in the buffer of its first byte.
+         * \param value The value to write. */
+        void patchFixed(size_t position, uint32_t value);
+        
+};
+
+#endif
@@ -2,8 +2,11 @@
 #include <iostream>
 
 
-Robot::Robot(int speedRating, int sizeRating)
-    : BaseObject('r',speedRating,sizeRating){
+Robot::Robot(Environment* env, int speedRating, int sizeRating)
+    : BaseObject(env,'r',speedRating,sizeRating){
+    pairedTargetID = -1;
+    targetAngleOffset = 0;
+    targetDistance = 0;
     collideMyTarget = false;
     collideOtherTarget = false;
 }
@@ -30,8 +33,9 @@ void Robot::sensorScans(){
         analyzeTargetCollisions( collidingObjs );
     }
 
-    // If the robot isn't colliding with anything, then it should continue homing in on target
-    if(collidingObjs.size() == 0){
+    // If the robot isn't colliding with anything, then it should continue homing in on target.
+    // Robots left without a target when there were more robots than targets keep their heading.
+    if(collidingObjs.size() == 0 && env -> hasObject( pairedTargetID )){
 
         std::pair<int,int> homingPair = env -> homingSensorReading( id );
 
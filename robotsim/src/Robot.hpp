@@ -20,16 +20,17 @@ class Robot : public BaseObject {
     public:
 
         /*! Robot Constructor.
+         * \param env The environment which the robot resides in.
          * \param speedRating A standardized speed scale rating which is used to set the actual robot speed.
          * \param sizeRating A standardized size scale rating which is used to set the actual robot radius. */
-        Robot(int speedRating, int sizeRating);
+        Robot(Environment* env, int speedRating, int sizeRating);
         
         
         /*! Destructor for the Robot */
         ~Robot();
     
     
-        /*! Returns the ID number of the target linked to this robot (if any) */
+        /*! Returns the ID number of the target linked to this robot, or -1 if there is none */
         int getPairedTargetID();
 
 
@@ -1,5 +1,6 @@
 #include "Simulation.hpp"
 #include <iostream>
+#include <ctime>
 
 #define PI 3.1415926535f
 
@@ -24,8 +25,9 @@ Simulation::Simulation(int argc, char* argv[], int width, int height) : BaseGfxA
     gluOrtho2D(0, m_width, 0, m_height);
     glViewport(0, 0, m_width, m_height);
 
-    /*! Creating the environment */
-    env = new Environment( width, height, scaleFactor );
+    /*! Creating the environment with two robots, two targets, and six obstacles, seeded from the clock so each
+     *  run starts differently */
+    env = new Environment( width, height, scaleFactor, 2, 2, 6, time( NULL ) );
 
     setColorCodes();
 
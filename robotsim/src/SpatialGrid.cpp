@@ -0,0 +1,75 @@
+#include "SpatialGrid.hpp"
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(){
+    reset(1,1,1);
+}
+
+/*! Clears every cell and sizes the grid so that cells are at least cellSize wide, and no more than
+ *  MAX_CELLS_PER_SIDE cells run along either side */
+void SpatialGrid::reset(int width, int height, int cellSize){
+
+    width = std::max(width,1);
+    height = std::max(height,1);
+    cellSize = std::max(cellSize,1);
+
+    const int largestSide = std::max(width,height);
+    if( largestSide / cellSize >= MAX_CELLS_PER_SIDE ){
+        cellSize = largestSide / MAX_CELLS_PER_SIDE + 1;
+    }
+
+    this->cellSize = cellSize;
+    cols = width / cellSize + 1;
+    rows = height / cellSize + 1;
+
+    // Emptying the cells without giving back their memory
+    const int numCells = cols*rows;
+    for(int i = 0; i < std::min( numCells, static_cast<int>( cells.size() ) ); i++){
+        cells[i].clear();
+    }
+    cells.resize( numCells );
+
+}
+
+/*! Stores the object index in the cell which contains (x,y) */
+void SpatialGrid::insert(int index, int x, int y){
+    cells[ getRow(y)*cols + getCol(x) ].push_back( index );
+}
+
+/*! Appends the indices stored in every cell touching the rectangle */
+void SpatialGrid::query(int xMin, int yMin, int xMax, int yMax, std::vector<int>& indices) const{
+
+    const int colMin = getCol(xMin);
+    const int colMax = getCol(xMax);
+    const int rowMin = getRow(yMin);
+    const int rowMax = getRow(yMax);
+
+    for(int row = rowMin; row <= rowMax; row++){
+        for(int col = colMin; col <= colMax; col++){
+
+            const std::vector<int>& cell = cells[ row*cols + col ];
+            indices.insert( indices.end(), cell.begin(), cell.end() );
+        }
+    }
+
+}
+
+int SpatialGrid::getCellSize() const{
+    return cellSize;
+}
+
+int SpatialGrid::getCol(int x) const{
+
+    if( x < 0 ){
+        return 0;
+    }
+    return std::min( x / cellSize, cols - 1 );
+}
+
+int SpatialGrid::getRow(int y) const{
+
+    if( y < 0 ){
+        return 0;
+    }
+    return std::min( y / cellSize, rows - 1 );
+}
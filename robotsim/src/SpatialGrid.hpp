@@ -0,0 +1,83 @@
+/**
+ * \author George Brown
+ *
+ * \file  SpatialGrid.hpp
+ * \brief A uniform grid over the environment which buckets objects by the cell containing their center,
+ *        so that collision queries only look at objects in nearby cells instead of every object.
+ *
+ */
+
+#ifndef SPATIAL_GRID_HPP
+#define SPATIAL_GRID_HPP
+
+#include <vector>
+
+/*! The SpatialGrid class divides the environment into square cells and stores, for each cell, the indices of
+ *  the objects whose centers lie in it. Positions outside the environment are clamped to the border cells. */
+class SpatialGrid{
+        
+    public:
+        
+        /*! Most cells along either side of the grid. Larger cells are used when objects are small compared to
+         *  the environment, which keeps the memory used by the grid bounded. */
+        static const int MAX_CELLS_PER_SIDE = 1024;
+        
+        
+        /*! SpatialGrid constructor. The grid starts with a single cell. */
+        SpatialGrid();
+        
+        
+        /*! Removes all objects and resizes the grid.
+         * \param width The width of the area covered by the grid.
+         * \param height The height of the area covered by the grid.
+         * \param cellSize The smallest allowed cell edge length. */
+        void reset(int width, int height, int cellSize);
+        
+        
+        /*! Adds an object to the cell containing its center.
+         * \param index The index of the object in the environment's container of objects.
+         * \param x The X-position of the object's center.
+         * \param y The Y-position of the object's center. */
+        void insert(int index, int x, int y);
+        
+        
+        /*! Collects the indices of all objects whose centers lie in cells overlapping a rectangle.
+         *  Every object centered inside the rectangle is found, along with some nearby ones.
+         * \param xMin The left edge of the rectangle.
+         * \param yMin The bottom edge of the rectangle.
+         * \param xMax The right edge of the rectangle.
+         * \param yMax The top edge of the rectangle.
+         * \param indices The object indices are appended to this vector. */
+        void query(int xMin, int yMin, int xMax, int yMax, std::vector<int>& indices) const;
+        
+        
+        /*! Returns the edge length of the cells */
+        int getCellSize() const;
+        
+        
+    private:
+        
+        /*! Edge length of the cells */
+        int cellSize;
+        
+        /*! Number of cells along the X-axis */
+        int cols;
+        
+        /*! Number of cells along the Y-axis */
+        int rows;
+        
+        /*! Object indices stored in each cell, row by row. The vectors keep their capacity between resets
+         *  so that rebuilding the grid every update does not reallocate. */
+        std::vector< std::vector<int> > cells;
+        
+        
+        /*! Returns the column containing an X-position, clamped to the grid */
+        int getCol(int x) const;
+        
+        
+        /*! Returns the row containing a Y-position, clamped to the grid */
+        int getRow(int y) const;
+        
+};
+
+#endif
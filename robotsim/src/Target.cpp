@@ -1,8 +1,8 @@
 #include "Target.hpp"
 
 
-Target::Target(int speedRating, int sizeRating)
-    : BaseObject('t',speedRating, sizeRating){
+Target::Target(Environment* env, int speedRating, int sizeRating)
+    : BaseObject(env,'t',speedRating, sizeRating){
 }
 
 
@@ -20,9 +20,10 @@ class Target : public BaseObject{
     public:
     
         /*! Target Constructor.
+         * \param env The environment which the target resides in.
          * \param speedRating A standardized speed scale rating which is used to set the actual target speed.
          * \param sizeRating A standardized size scale rating which is used to set the actual target radius. */
-        Target(int speedRating, int sizeRating);
+        Target(Environment* env, int speedRating, int sizeRating);
 
 
         /*! Target Destructor */
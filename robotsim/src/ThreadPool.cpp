@@ -0,0 +1,110 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int numThreads){
+
+    if( numThreads <= 0 ){
+        numThreads = std::max( 1, static_cast<int>( std::thread::hardware_concurrency() ) );
+    }
+
+    body = 0;
+    loopBegin = 0;
+    loopEnd = 0;
+    chunkSize = 1;
+    nextChunk = 0;
+    loopCount = 0;
+    busyWorkers = 0;
+    stopping = false;
+
+    for(int i = 1; i < numThreads; i++){
+        workers.push_back( std::thread( &ThreadPool::workerLoop, this ) );
+    }
+}
+
+ThreadPool::~ThreadPool(){
+
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    loopStarted.notify_all();
+
+    for(int i = 0; i < static_cast<int>( workers.size() ); i++){
+        workers[i].join();
+    }
+}
+
+int ThreadPool::getNumThreads() const{
+    return workers.size() + 1;
+}
+
+/*! Method which runs the body over the range on every thread of the pool. Threads take chunks from a shared counter,
+ *  so a thread which finishes early takes over work which would otherwise wait for a slower thread. */
+void ThreadPool::parallelFor(int begin, int end, const std::function<void(int,int)>& body){
+
+    if( end <= begin ){
+        return;
+    }
+
+    if( workers.size() == 0 ){
+        body( begin, end );
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        this->body = &body;
+        loopBegin = begin;
+        loopEnd = end;
+
+        // Several chunks per thread evens out objects which take longer than others
+        chunkSize = std::max( 1, ( end - begin ) / ( 4 * getNumThreads() ) );
+        nextChunk = 0;
+        busyWorkers = workers.size();
+        loopCount++;
+    }
+    loopStarted.notify_all();
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock( mutex );
+    workerFinished.wait( lock, [this]{ return busyWorkers == 0; } );
+    this->body = 0;
+}
+
+void ThreadPool::runChunks(){
+
+    while( true ){
+
+        const int first = loopBegin + chunkSize * nextChunk.fetch_add( 1 );
+        if( first >= loopEnd ){
+            return;
+        }
+        ( *body )( first, std::min( first + chunkSize, loopEnd ) );
+    }
+}
+
+void ThreadPool::workerLoop(){
+
+    int loopsSeen = 0;
+
+    while( true ){
+
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            loopStarted.wait( lock, [this, loopsSeen]{ return stopping || loopCount != loopsSeen; } );
+            if( stopping ){
+                return;
+            }
+            loopsSeen = loopCount;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            busyWorkers--;
+        }
+        workerFinished.notify_one();
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * \author George Brown
+ *
+ * \file  ThreadPool.hpp
+ * \brief A fixed set of worker threads which split loops over index ranges between them. The environment uses it
+ *        to run the phases of an update across several cores.
+ *
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/*! The ThreadPool class keeps its worker threads waiting between loops. The calling thread works on each loop as
+ *  well, so a pool of one thread runs loops inline without starting any workers. */
+class ThreadPool{
+        
+    public:
+        
+        /*! ThreadPool constructor.
+         * \param numThreads The number of threads which work on each loop, including the calling thread.
+         *                   0 uses one thread per hardware thread. */
+        ThreadPool(int numThreads);
+        
+        
+        /*! ThreadPool destructor. Waits for the workers to finish and joins them. */
+        ~ThreadPool();
+        
+        
+        /*! Thread pools own threads, so they are not copied */
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        
+        
+        /*! Returns the number of threads which work on each loop, including the calling thread */
+        int getNumThreads() const;
+        
+        
+        /*! Splits the range [begin, end) into chunks and runs the body on each chunk on some thread. Returns once
+         *  every chunk is done. Chunks may run in any order, so the body must not depend on the order.
+         * \param begin The first index of the range.
+         * \param end The index just past the range.
+         * \param body Function which is called with the first index and the index just past each chunk. */
+        void parallelFor(int begin, int end, const std::function<void(int,int)>& body);
+        
+        
+    private:
+        
+        /*! Worker threads, one fewer than the number of threads working on each loop */
+        std::vector<std::thread> workers;
+        
+        /*! Guards the loop description and the counters below */
+        std::mutex mutex;
+        
+        /*! Signals the workers that a new loop has started or that the pool is shutting down */
+        std::condition_variable loopStarted;
+        
+        /*! Signals the calling thread that a worker finished its part of the loop */
+        std::condition_variable workerFinished;
+        
+        /*! The body of the current loop */
+        const std::function<void(int,int)>* body;
+        
+        /*! The range of the current loop, and the size of its chunks */
+        int loopBegin;
+        int loopEnd;
+        int chunkSize;
+        
+        /*! Index of the next chunk to hand out */
+        std::atomic<int> nextChunk;
+        
+        /*! Number of loops started so far, which lets the workers tell a new loop from the one they last worked on */
+        int loopCount;
+        
+        /*! Number of workers still working on the current loop */
+        int busyWorkers;
+        
+        /*! Flag which is true when the workers should exit */
+        bool stopping;
+        
+        
+        /*! Takes chunks of the current loop and runs the body on them until none are left */
+        void runChunks();
+        
+        
+        /*! Main function of each worker thread */
+        void workerLoop();
+        
+};
+
+#endif